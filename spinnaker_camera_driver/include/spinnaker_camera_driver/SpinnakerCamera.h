@@ -48,15 +48,19 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sensor_msgs/fill_image.h>
 #include <spinnaker_camera_driver/camera_exceptions.h>
 
+#include <memory>
 #include <sstream>
 #include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 // Header generated by dynamic_reconfigure
 #include <spinnaker_camera_driver/SpinnakerConfig.h>
 #include "spinnaker_camera_driver/camera.h"
 #include "spinnaker_camera_driver/cm3.h"
-#include "spinnaker_camera_driver/set_property.h"
+#include "spinnaker_camera_driver/spinnaker_system.h"
+#include "spinnaker_camera_driver/user_set.h"
 
 // Spinnaker SDK
 #include "Spinnaker.h"
@@ -74,20 +78,37 @@ public:
   * \brief Function that allows reconfiguration of the camera.
   *
   * This function handles a reference of a camera_library::CameraConfig object and
-  * configures the camera as close to the given values as possible.  As a function for
-  * dynamic_reconfigure, values that are not valid are changed by the driver and can
-  * be inspected after this function ends.
-  * This function will stop and restart the camera when called on a SensorLevels::RECONFIGURE_STOP level.
-  * \param config  camera_library::CameraConfig object passed by reference.  Values will be changed to those the driver
-  * is currently using.
+  * configures the camera as close to the given values as possible, writing only the features that changed since the
+  * last configuration. Acquisition is stopped and restarted only if a stream parameter changed or a feature that is
+  * locked while streaming changed (see Camera::needsAcquisitionStop), and only on a SensorLevels::RECONFIGURE_STOP
+  * level or for the first configuration after connecting. Everything else is applied while streaming.
+  * \param config  camera_library::CameraConfig object passed by reference.
   * \param level  Reconfiguration level. See constants below for details.
   *
-  * \return Returns true when the configuration could be applied without modification.
+  * \throws std::runtime_error if the camera is not connected. Connecting is left to the caller.
   */
   void setNewConfiguration(const spinnaker_camera_driver::SpinnakerConfig& config, const uint32_t& level);
 
+  /*!
+  * \brief Sets the ROI, moving it while streaming whenever the camera allows.
+  *
+  * Acquisition is only restarted for a change of size the camera does not accept while streaming.
+  */
   void setROI(const int x_offset, const int y_offset, const int roi_width, const int roi_height);
 
+  /// Timing of the ROI updates since the driver started.
+  struct RoiStatistics
+  {
+    uint64_t updates;      ///< ROI updates applied.
+    uint64_t restarts;     ///< Updates that had to restart acquisition.
+    uint64_t frames_lost;  ///< Frames estimated lost while restarting, from the frame rate. Not counted when triggered.
+    double last_latency;   ///< Seconds the last update took to write.
+    double max_latency;    ///< Longest update in seconds.
+    double last_blackout;  ///< Seconds acquisition was stopped for the last restart.
+  };
+
+  RoiStatistics getRoiStatistics() const;
+
   /** Parameters that need a sensor to be stopped completely when changed. */
   static const uint8_t LEVEL_RECONFIGURE_CLOSE = 3;
 
@@ -108,6 +129,22 @@ public:
   */
   void connect();
 
+  /// Outcome of grabImage, reported as a value since these are part of normal operation.
+  enum GrabResult
+  {
+    GRAB_OK,
+    GRAB_INCOMPLETE,
+    GRAB_TIMEOUT
+  };
+
+  typedef std::vector<std::pair<std::string, double> > StageTimes;
+
+  /// Time in seconds each stage of the last connect() took, in the order they ran.
+  const StageTimes& getConnectTimes() const
+  {
+    return connect_times_;
+  }
+
   /*!
   * \brief Disconnects from the camera.
   *
@@ -136,20 +173,45 @@ public:
   * This function will load the raw data from the buffer and place it into a sensor_msgs::Image.
   * \param image sensor_msgs::Image that will be filled with the image currently in the buffer.
   * \param frame_id The name of the optical frame of the camera.
+  * \return GRAB_OK if image was filled in, GRAB_INCOMPLETE if the frame arrived incomplete, in which case only the
+  * header is filled in, and GRAB_TIMEOUT if no frame arrived within the timeout. Faults are thrown as exceptions.
   */
-  void grabImage(sensor_msgs::Image* image, const std::string& frame_id);
+  GrabResult grabImage(sensor_msgs::Image* image, const std::string& frame_id);
 
   /*!
   * \brief Will set grabImage timeout for the camera.
   *
-  * This function will set the time required for grabCamera to throw a timeout exception.  Must be called after
+  * This function will set the time after which grabImage reports GRAB_TIMEOUT.  Must be called after
   * connect().
-  * \param timeout The desired timeout value (in seconds)
+  * \param timeout The desired timeout value (in seconds), 0 to derive it from the configuration. Free running it then
+  * covers a few frame periods plus the exposure, when triggered it is short so that the grab thread stays responsive
+  * between triggers.
   *
   */
-  // TODO(mhosmar): Implement later
   void setTimeout(const double& timeout);
 
+  /// Timeout currently used by grabImage, in seconds.
+  double getTimeout() const
+  {
+    return timeout_ / 1000.0;
+  }
+
+  /*!
+  * \brief Latches the camera clock, for anchoring the mapping of frame timestamps onto ROS time.
+  *
+  * \param camera_stamp Set to the latched camera time, in nanoseconds.
+  * \param host_before Set to the ROS time just before the latch command.
+  * \param host_after Set to the ROS time once the latched value was read.
+  * \return false if the camera has no timestamp latch.
+  */
+  bool latchTimestamp(uint64_t* camera_stamp, ros::Time* host_before, ros::Time* host_after);
+
+  /// Whether the camera waits for a trigger, so that timeouts are expected.
+  bool isTriggered() const
+  {
+    return trigger_enabled_;
+  }
+
   /*!
   * \brief Used to set the serial number for the camera you wish to connect to.
   *
@@ -160,26 +222,59 @@ public:
   */
   void setDesiredCamera(const uint32_t& id);
 
+  /*!
+  * \brief Keeps the configuration in a camera UserSet so that connecting can load it in a single operation.
+  *
+  * The first configuration after connecting is loaded from the UserSet if the hash stored in hash_path matches it.
+  * Otherwise it is written property by property, saved into the UserSet, which also becomes the set the camera
+  * starts up with, and its hash is stored. This function should be called before connect().
+  * \param user_set UserSet to use, e.g. UserSet1, or empty to always write the configuration.
+  * \param hash_path File that keeps the hash of the configuration saved in the UserSet.
+  */
+  void setUserSet(const std::string& user_set, const std::string& hash_path);
+
   void setGain(const float& gain);
   int getHeightMax();
   int getWidthMax();
   Spinnaker::GenApi::CNodePtr readProperty(const Spinnaker::GenICam::gcstring property_name);
 
+  /*!
+  * \brief Reads a node of the transport layer stream node map, such as the buffer counters.
+  *
+  * \return The node, or a null pointer if the camera is not connected or the node is not available.
+  */
+  Spinnaker::GenApi::CNodePtr readStreamProperty(const Spinnaker::GenICam::gcstring property_name);
+
   uint32_t getSerial()
   {
     return serial_;
   }
 
+  /*!
+  * \brief Counts node requests against the camera's node maps since connecting.
+  *
+  * \param lookups Set to the number of requests that had to go through a node map.
+  * \param hits Set to the number of requests served from the cache instead.
+  */
+  void getNodeCacheStatistics(uint64_t* lookups, uint64_t* hits) const;
+
+  /// Capabilities of the features the driver uses, as probed when connecting. Empty before connecting.
+  std::vector<std::pair<std::string, NodeCache::Capability> > getCapabilities() const;
+
 private:
   uint32_t serial_;  ///< A variable to hold the serial number of the desired camera.
 
-  Spinnaker::SystemPtr system_;
-  Spinnaker::CameraList camList_;
+  std::shared_ptr<SpinnakerSystem> system_;  ///< Shared with every other camera in the process.
   Spinnaker::CameraPtr pCam_;
 
   // TODO(mhosmar) use std::shared_ptr
   Spinnaker::GenApi::INodeMap* node_map_;
-  std::shared_ptr<Camera> camera_;
+  /// Node handles of the device and stream node maps, resolved once per connection.
+  std::shared_ptr<NodeCache> node_cache_;
+  std::shared_ptr<NodeCache> stream_node_cache_;
+  std::shared_ptr<Camera> camera_;  ///< Uses node_cache_, so the two are only replaced together.
+  /// Guards replacing camera_ and the node caches. Threads other than the acquisition thread read through copies.
+  mutable std::mutex handles_mutex_;
 
   Spinnaker::ChunkData image_metadata_;
 
@@ -198,7 +293,57 @@ private:
   /// GigE packet delay:
   unsigned int packet_delay_;
 
-  uint64_t timeout_;
+  uint64_t timeout_;          ///< Grab timeout in milliseconds.
+  double fixed_timeout_;      ///< Timeout set through setTimeout in seconds, 0 to adapt it to the configuration.
+  bool trigger_enabled_;      ///< Whether the last configuration enabled the trigger.
+
+  StageTimes connect_times_;  ///< Stage timing of the last connect().
+
+  std::string user_set_;            ///< UserSet that holds the configuration, empty if not used.
+  std::string user_set_hash_path_;  ///< File with the hash of the configuration saved in user_set_.
+
+  mutable std::mutex roi_statistics_mutex_;  ///< Kept apart from mutex_, which a frame grab holds.
+  RoiStatistics roi_statistics_;
+
+  bool stream_configured_;  ///< Whether stream_config_ holds the stream parameters applied since connecting.
+  spinnaker_camera_driver::SpinnakerConfig stream_config_;
+
+  /// Encoding of the frames currently streaming, looked up on the first frame after start() rather than per frame.
+  std::string encoding_;
+  Spinnaker::PixelFormatEnums encoding_pixel_format_;  ///< Pixel format encoding_ was resolved for.
+  bool encoding_valid_;
+
+  bool restart_once_auto_modes_;  ///< Whether start() has yet to restart the Once auto modes since connecting.
+
+  /*!
+  * \brief Maps a Spinnaker pixel format onto a sensor_msgs image encoding.
+  *
+  * Common formats are resolved from a table. Any other format falls back to inspecting PixelColorFilter, which
+  * costs a GenApi round trip, so this should only be called when the pixel format changes.
+  */
+  std::string resolveEncoding(const Spinnaker::PixelFormatEnums pixel_format, const size_t bitsPerPixel);
+
+  /// Derives the grab timeout from the frame rate, exposure and trigger mode unless it was set explicitly.
+  void updateTimeout(const spinnaker_camera_driver::SpinnakerConfig& config);
+
+  /// Applies the stream buffer parameters to the transport layer stream node map. Must be called while stopped.
+  void configureStream(const spinnaker_camera_driver::SpinnakerConfig& config);
+
+  /// Whether the stream buffer parameters differ from the ones applied since connecting.
+  bool streamConfigChanged(const spinnaker_camera_driver::SpinnakerConfig& config) const;
+
+  /// Copies camera_ and the node caches under handles_mutex_, for each pointer that is not null.
+  void getHandles(std::shared_ptr<Camera>* camera, std::shared_ptr<NodeCache>* node_cache,
+                  std::shared_ptr<NodeCache>* stream_node_cache) const;
+
+  /// Replaces camera_ and the node caches at once, so that no reader sees a Camera with another connection's cache.
+  void setHandles(const std::shared_ptr<Camera>& camera, const std::shared_ptr<NodeCache>& node_cache,
+                  const std::shared_ptr<NodeCache>& stream_node_cache);
+
+  /// Applies the first configuration after connecting through user_set_, see setUserSet.
+  void applyUserSet(const spinnaker_camera_driver::SpinnakerConfig& config, const uint32_t& level);
+  bool loadUserSet();
+  bool saveUserSet();
 
   // This function configures the camera to add chunk data to each image. It does
   // this by enabling each type of chunk data before enabling chunk data mode.
@@ -29,7 +29,8 @@ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSI
 
 // Header generated by dynamic_reconfigure
 #include <spinnaker_camera_driver/SpinnakerConfig.h>
-#include "spinnaker_camera_driver/set_property.h"
+#include "spinnaker_camera_driver/camera_features.h"
+#include "spinnaker_camera_driver/config_transaction.h"
 
 // Spinnaker SDK
 #include "Spinnaker.h"
@@ -47,12 +48,35 @@ namespace spinnaker_camera_driver
 class Camera
 {
 public:
-  explicit Camera(Spinnaker::GenApi::INodeMap* node_map);
+  /// \param model Selects the node names and features of the model in the feature tables.
+  explicit Camera(NodeCache* node_map, const CameraModel model = MODEL_BLACKFLY_S);
   ~Camera()
   {
   }
   virtual void setNewConfiguration(const spinnaker_camera_driver::SpinnakerConfig& config, const uint32_t& level);
 
+  /*!
+  * \brief Whether applying a configuration needs acquisition stopped.
+  *
+  * That is the case for the image format and the features marked locked while streaming in the feature tables, and
+  * only when one of them changed.
+  */
+  bool needsAcquisitionStop(const spinnaker_camera_driver::SpinnakerConfig& config) const;
+
+  /// Whether a configuration has been applied since connecting.
+  bool hasAppliedConfiguration() const
+  {
+    return config_applied_;
+  }
+
+  /*!
+  * \brief Takes over a configuration the camera already holds, e.g. after loading it from a UserSet.
+  *
+  * Reads back the image size limits and the ROI, and records the configuration as applied so that later
+  * reconfigures only write what differs from it.
+  */
+  void configurationLoaded(const spinnaker_camera_driver::SpinnakerConfig& config);
+
   /** Parameters that need a sensor to be stopped completely when changed. */
   static const uint8_t LEVEL_RECONFIGURE_CLOSE = 3;
 
@@ -62,8 +86,26 @@ public:
   /** Parameters that can be changed while a sensor is streaming. */
   static const uint8_t LEVEL_RECONFIGURE_RUNNING = 0;
 
+  /// Writes the ROI, restoring the previous one and throwing std::runtime_error if the camera does not take it.
   virtual void setROI(const int x_offset, const int y_offset, const int roi_width, const int roi_height);
+
+  /*!
+  * \brief Whether setting an ROI of this size needs acquisition stopped.
+  *
+  * Only a change of size can, and only if the camera does not accept the new size while streaming. Moving the ROI
+  * never does.
+  */
+  bool roiNeedsAcquisitionStop(const int roi_width, const int roi_height);
+
   virtual void setGain(const float& gain);
+
+  /*!
+  * \brief Writes the auto exposure, gain and white balance set to Once again, for after acquisition started.
+  *
+  * Once runs a single adjustment on streamed frames. The configuration is written before acquisition starts after
+  * connecting, so its Once modes are written again once acquisition has started.
+  */
+  void restartOnceAutoModes();
   int getHeightMax() const;
   int getWidthMax() const;
 
@@ -75,8 +117,29 @@ public:
   Spinnaker::GenApi::CNodePtr
   readProperty(const Spinnaker::GenICam::gcstring property_name);
 
+  /// Node names of every feature the driver uses on this model, for probing the camera's capabilities.
+  std::vector<std::string> featureNames() const;
+
 protected:
-  Spinnaker::GenApi::INodeMap* node_map_;
+  NodeCache* node_map_;  ///< The camera's node map, through the cache owned by SpinnakerCamera.
+  CameraModel model_;
+
+  /*!
+  * \brief Compares a configuration against the one last applied to the camera.
+  *
+  * Everything counts as changed until a configuration has been applied, so the first one after connecting writes
+  * every feature.
+  */
+  ConfigChanges diffConfiguration(const spinnaker_camera_driver::SpinnakerConfig& config) const;
+
+  /// Records the configuration now on the camera, or forgets it after a failure so that the next one is written whole.
+  void configurationApplied(const spinnaker_camera_driver::SpinnakerConfig& config, bool success);
+
+  /// Sets the image format fields of config back to the ones last applied, for when they were not written.
+  void keepImageFormat(spinnaker_camera_driver::SpinnakerConfig* config) const;
+
+  /// Reads back a float feature after writing it, leaving value alone if it cannot be read.
+  void readWritten(const Spinnaker::GenICam::gcstring& property_name, double* value);
 
   virtual void init();
 
@@ -85,14 +148,37 @@ protected:
 
   int roi_x_offset_, roi_y_offset_, roi_width_, roi_height_;
 
+  bool config_applied_;                                      ///< Whether applied_config_ reflects the camera.
+  spinnaker_camera_driver::SpinnakerConfig applied_config_;  ///< Kept in step with setGain and setROI as well.
+  ConfigChanges unapplied_;  ///< Groups the last configuration could not write completely, written again next time.
+
   /*!
-  * \brief Changes the video mode of the connected camera.
+  * \brief Writes binning, decimation, ROI and pixel format, which need acquisition stopped.
   *
-  * This function will change the camera to the desired videomode and allow up the maximum framerate for that mode.
-  * \param videoMode string of desired video mode, will be changed if unsupported.
+  * \param skipped Gets the image format group set if a feature the camera has could not be written.
+  * \param recorded The fields of the features that could not be written are set back to the ones last applied.
   */
-  virtual void setFrameRate(const float frame_rate);
-  virtual void setImageControlFormats(const spinnaker_camera_driver::SpinnakerConfig& config);
+  void setImageControlFormats(ConfigTransaction* transaction, const spinnaker_camera_driver::SpinnakerConfig& config,
+                              ConfigChanges* skipped, spinnaker_camera_driver::SpinnakerConfig* recorded);
+
+  /// Reads the ROI the camera currently has into roi_width_, roi_height_ and the offsets.
+  void readROI();
+
+  /*!
+  * \brief Writes the ROI as part of a larger configuration, see setROI.
+  *
+  * Only values that differ from the cached ROI are written, and the cached ROI only takes the ones the camera took.
+  * \return Whether every value that differed was written.
+  */
+  bool applyROI(ConfigTransaction* transaction, const int x_offset, const int y_offset, const int roi_width,
+                const int roi_height);
+
+  /// Records the cached ROI in applied_config_.
+  void recordROI();
+
+  /// The size an ROI dimension selects, zero or anything larger than the sensor selecting the full size.
+  int clampROIWidth(const int roi_width) const;
+  int clampROIHeight(const int roi_height) const;
   /*!
   * \brief Set parameters relative to GigE cameras.
   *
@@ -0,0 +1,98 @@
+/**
+Software License Agreement (BSD)
+
+\file      camera_features.h
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef SPINNAKER_CAMERA_DRIVER_CAMERA_FEATURES_H
+#define SPINNAKER_CAMERA_DRIVER_CAMERA_FEATURES_H
+
+// Header generated by dynamic_reconfigure
+#include <spinnaker_camera_driver/SpinnakerConfig.h>
+
+#include <string>
+
+namespace spinnaker_camera_driver
+{
+/// Camera models with their own column in the feature tables.
+enum CameraModel
+{
+  MODEL_BLACKFLY_S,  ///< Also used for models that are not recognized.
+  MODEL_CHAMELEON3,
+  MODEL_COUNT
+};
+
+/// Groups of features that are written together, in the order they have to be written.
+struct ConfigChanges
+{
+  bool image_format;
+  bool frame_rate;
+  bool trigger_setup;  ///< Selector, source or activation, which need the trigger off while they change.
+  bool trigger_mode;
+  bool lines;
+  bool exposure;
+  bool sharpening;
+  bool saturation;
+  bool gain;
+  bool black_level;
+  bool gamma;
+  bool white_balance;
+  bool reverse;
+};
+
+/// Node name of a feature per CameraModel, null where the model does not have the feature.
+struct FeatureNodes
+{
+  const char* names[MODEL_COUNT];
+};
+
+/**
+ * One row of a feature table: which node a configuration field is written to on each model, and when.
+ *
+ * Only the value member named by type is set. The tables list the features in the order they are
+ * written, so dependencies such as a selector preceding the feature it selects are expressed by the row order.
+ */
+struct FeatureDescriptor
+{
+  enum Type
+  {
+    TYPE_FLOAT,   ///< float_field, written as a float and clamped to the node limits.
+    TYPE_INT,     ///< int_field, clamped to the node limits.
+    TYPE_BOOL,    ///< bool_field.
+    TYPE_ENUM,    ///< enum_field holds the name of the entry.
+    TYPE_ENTRY,   ///< Always selects the entry named by entry, e.g. to turn something off first.
+    TYPE_ENABLE   ///< Always writes true.
+  };
+
+  FeatureNodes nodes;
+  Type type;
+  bool ConfigChanges::*group;  ///< The feature is only written when this group changed.
+  bool (*condition)(const SpinnakerConfig& config);  ///< Additionally needs to hold, unless null.
+  bool optional;  ///< Not present on every variant of the model, skip without a warning if it is unavailable.
+  bool locked;    ///< The camera only takes a new value while acquisition is stopped.
+
+  double SpinnakerConfig::*float_field;
+  int SpinnakerConfig::*int_field;
+  bool SpinnakerConfig::*bool_field;
+  std::string SpinnakerConfig::*enum_field;
+  const char* entry;
+};
+}  // namespace spinnaker_camera_driver
+#endif  // SPINNAKER_CAMERA_DRIVER_CAMERA_FEATURES_H
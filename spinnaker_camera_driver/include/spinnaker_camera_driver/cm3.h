@@ -28,16 +28,12 @@ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSI
 
 namespace spinnaker_camera_driver
 {
+/// The Chameleon3, whose differences from the Blackfly S are listed in the feature tables.
 class Cm3 : public Camera
 {
 public:
-  explicit Cm3(Spinnaker::GenApi::INodeMap* node_map);
+  explicit Cm3(NodeCache* node_map);
   ~Cm3();
-  void setFrameRate(const float frame_rate);
-  void setNewConfiguration(const SpinnakerConfig& config, const uint32_t& level);
-
-private:
-  void setImageControlFormats(const spinnaker_camera_driver::SpinnakerConfig& config);
 };
 }  // namespace spinnaker_camera_driver
 #endif  // SPINNAKER_CAMERA_DRIVER_CM3_H
@@ -0,0 +1,107 @@
+/**
+Software License Agreement (BSD)
+
+\file      config_transaction.h
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef SPINNAKER_CAMERA_DRIVER_CONFIG_TRANSACTION_H
+#define SPINNAKER_CAMERA_DRIVER_CONFIG_TRANSACTION_H
+
+// Spinnaker SDK
+#include "Spinnaker.h"
+#include "SpinGenApi/SpinnakerGenApi.h"
+
+#include "spinnaker_camera_driver/node_cache.h"
+
+#include <string>
+#include <vector>
+
+namespace spinnaker_camera_driver
+{
+/**
+ * Groups the property writes of one configuration pass so that they succeed or fail together.
+ *
+ * Writes go to the camera right away, since limits such as WidthMax follow from earlier writes like the binning, but
+ * each one remembers the value it replaced. commit() keeps them and logs a single summary of what changed. If the
+ * transaction goes out of scope without being committed, e.g. because a write threw, the writes are undone in reverse
+ * order. Undoing in reverse also restores selector nodes such as BalanceRatioSelector between the values they select.
+ *
+ * Properties that are not implemented, available or writable are skipped and listed in the summary, as many of them
+ * only exist on some models. For properties the node cache has probed, missing features and enumeration entries are
+ * rejected and values within the probed limits written without asking the camera first.
+ */
+class ConfigTransaction
+{
+public:
+  explicit ConfigTransaction(NodeCache* node_map);
+
+  /// Undoes the writes unless commit() was called.
+  ~ConfigTransaction();
+
+  /// Selects the entry of an enumeration. Returns whether the property was written.
+  bool set(const std::string& property_name, const std::string& entry_name);
+  bool set(const std::string& property_name, const char* entry_name);
+
+  /// Writes a value, clamped to the current limits of the property. Returns whether the property was written.
+  bool set(const std::string& property_name, float value);
+  bool set(const std::string& property_name, int value);
+  bool set(const std::string& property_name, bool value);
+
+  /// Writes the maximum of an integer property.
+  bool setMax(const std::string& property_name);
+
+  /// Keeps the writes and logs the summary.
+  void commit();
+
+  /// Undoes the writes made so far, most recent first.
+  void rollback();
+
+  /// Number of properties written so far.
+  size_t size() const
+  {
+    return writes_.size();
+  }
+
+private:
+  struct Write
+  {
+    std::string property_name;
+    Spinnaker::GenApi::CValuePtr node;
+    Spinnaker::GenICam::gcstring previous;  ///< Value before the write, to undo it.
+    std::string value;                      ///< Value written, for the summary.
+  };
+
+  /*!
+  * \brief Looks the property up and checks it can be written, recording why not otherwise.
+  *
+  * \param capability Set to what the property supported when probed. Without a probe it has no range or entries.
+  */
+  Spinnaker::GenApi::CNodePtr writableNode(const std::string& property_name, NodeCache::Capability* capability);
+
+  void record(const std::string& property_name, Spinnaker::GenApi::INode* node,
+              const Spinnaker::GenICam::gcstring& previous, const std::string& value);
+
+  NodeCache* node_map_;
+  std::vector<Write> writes_;
+  std::vector<std::string> skipped_;  ///< Properties that were not written, with the reason.
+  bool done_;                         ///< Whether the transaction was committed or rolled back.
+};
+}  // namespace spinnaker_camera_driver
+#endif  // SPINNAKER_CAMERA_DRIVER_CONFIG_TRANSACTION_H
@@ -0,0 +1,75 @@
+/**
+Software License Agreement (BSD)
+
+\file      debayer.h
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef SPINNAKER_CAMERA_DRIVER_DEBAYER_H
+#define SPINNAKER_CAMERA_DRIVER_DEBAYER_H
+
+#include <sensor_msgs/Image.h>
+
+#include <string>
+
+namespace spinnaker_camera_driver
+{
+/**
+ * Converts raw frames into the color and mono images image_proc/debayer would publish.
+ *
+ * The conversions are OpenCV's, which are vectorized and split each image into row stripes over OpenCV's thread
+ * pool. The output is written straight into the destination message, so a recycled message is not reallocated.
+ */
+class Debayer
+{
+public:
+  enum Algorithm
+  {
+    BILINEAR,
+    EDGE_AWARE
+  };
+
+  /*!
+  * \param algorithm Demosaicing algorithm for Bayer images.
+  * \param rgb Whether color images are rgb (true) or bgr (false).
+  */
+  Debayer(const Algorithm algorithm, const bool rgb);
+
+  /*!
+  * \brief Demosaics a Bayer image into rgb8/bgr8, or rgb16/bgr16 for 16-bit Bayer images.
+  *
+  * \return false if raw is not a Bayer image.
+  */
+  bool toColor(const sensor_msgs::Image& raw, sensor_msgs::Image* color) const;
+
+  /*!
+  * \brief Converts a Bayer or color image into mono8, or mono16 for 16-bit images.
+  *
+  * \return false if raw is neither a Bayer image nor a 3 or 4 channel color image.
+  */
+  bool toMono(const sensor_msgs::Image& raw, sensor_msgs::Image* mono) const;
+
+  static bool parseAlgorithm(const std::string& name, Algorithm* algorithm);
+
+private:
+  const Algorithm algorithm_;
+  const bool rgb_;
+};
+}  // namespace spinnaker_camera_driver
+#endif  // SPINNAKER_CAMERA_DRIVER_DEBAYER_H
@@ -95,6 +95,15 @@ public:
                      std::pair<float, float> operational = std::make_pair(0.0, 0.0), float lower_bound = 0,
                      float upper_bound = 0);
 
+  /*!
+   * \brief Add an integer diagnostic read from the transport layer stream node map
+   *
+   * Used for the stream buffer counters. Counters the transport layer does not
+   * provide are skipped rather than reported as errors.
+   * \param name is the name of the stream parameter, e.g. StreamDroppedFrameCount
+   */
+  void addStreamDiagnostic(const Spinnaker::GenICam::gcstring name);
+
 private:
   /*
    * diagnostic_params is aData Structure to represent a parameter and its
@@ -131,6 +140,7 @@ private:
   // vectors to keep track of the items to publish
   std::vector<diagnostic_params<int>> integer_params_;
   std::vector<diagnostic_params<float>> float_params_;
+  std::vector<diagnostic_params<int>> stream_params_;
   // Information about the device model, firmware, etc
   // TODO(mlowe): Allow these to be configured
   // clang-format off
@@ -0,0 +1,240 @@
+/**
+Software License Agreement (BSD)
+
+\file      frame_ring.h
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef SPINNAKER_CAMERA_DRIVER_FRAME_RING_H
+#define SPINNAKER_CAMERA_DRIVER_FRAME_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace spinnaker_camera_driver
+{
+/**
+ * Bounded ring that hands frames from the acquisition thread to the publishing thread.
+ *
+ * Exactly one thread may call push() and exactly one other thread may call pop()/waitPop(). Frames move through
+ * the ring without locks; each cell carries a sequence number telling whether it is free or holds a frame. When
+ * the ring is full the producer either discards the incoming frame (DROP_NEWEST) or takes the oldest frame out
+ * itself (DROP_OLDEST). Claiming a frame is a compare-and-swap on the read position, so the producer and the
+ * consumer can never both take the same frame.
+ */
+template <typename T>
+class FrameRing
+{
+public:
+  enum DropPolicy
+  {
+    DROP_OLDEST,
+    DROP_NEWEST
+  };
+
+  FrameRing(const size_t capacity, const DropPolicy policy)
+    : cells_(std::max<size_t>(capacity, 1))
+    , policy_(policy)
+    , write_pos_(0)
+    , read_pos_(0)
+    , pushed_(0)
+    , dropped_(0)
+    , peak_occupancy_(0)
+  {
+    for (size_t i = 0; i < cells_.size(); ++i)
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  /*!
+  * \brief Adds a frame, dropping one according to the policy if the ring is full.
+  *
+  * Must only be called from the producer thread.
+  * \return false if a frame had to be dropped.
+  */
+  bool push(T item)
+  {
+    bool dropped_any = false;
+    while (!tryPush(&item))
+    {
+      if (policy_ == DROP_NEWEST)
+      {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+
+      T oldest;
+      if (tryPop(&oldest))
+      {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        dropped_any = true;
+      }
+    }
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+
+    const size_t occupancy = size();
+    if (occupancy > peak_occupancy_.load(std::memory_order_relaxed))
+      peak_occupancy_.store(occupancy, std::memory_order_relaxed);
+
+    // The empty critical section orders this notification after a waiting consumer's emptiness check.
+    {
+      std::lock_guard<std::mutex> lock(wait_mutex_);
+    }
+    not_empty_.notify_one();
+    return !dropped_any;
+  }
+
+  /*!
+  * \brief Takes the oldest frame without blocking.
+  *
+  * \return false if the ring was empty.
+  */
+  bool pop(T* item)
+  {
+    return tryPop(item);
+  }
+
+  /*!
+  * \brief Takes the oldest frame, waiting up to timeout for one to arrive.
+  *
+  * \return false if the ring was still empty when the timeout expired.
+  */
+  template <typename Rep, typename Period>
+  bool waitPop(T* item, const std::chrono::duration<Rep, Period>& timeout)
+  {
+    if (tryPop(item))
+      return true;
+
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    return not_empty_.wait_for(lock, timeout, [this, item]() { return tryPop(item); });
+  }
+
+  /// Number of frames currently waiting to be consumed.
+  size_t size() const
+  {
+    const size_t write = write_pos_.load(std::memory_order_acquire);
+    const size_t read = read_pos_.load(std::memory_order_acquire);
+    return write > read ? write - read : 0;
+  }
+
+  size_t capacity() const
+  {
+    return cells_.size();
+  }
+
+  DropPolicy policy() const
+  {
+    return policy_;
+  }
+
+  /// Total frames accepted into the ring.
+  uint64_t pushed() const
+  {
+    return pushed_.load(std::memory_order_relaxed);
+  }
+
+  /// Total frames discarded because the ring was full.
+  uint64_t dropped() const
+  {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+  /// Highest occupancy observed since construction.
+  size_t peakOccupancy() const
+  {
+    return peak_occupancy_.load(std::memory_order_relaxed);
+  }
+
+  static bool parsePolicy(const std::string& name, DropPolicy* policy)
+  {
+    if (name == "drop_oldest")
+      *policy = DROP_OLDEST;
+    else if (name == "drop_newest")
+      *policy = DROP_NEWEST;
+    else
+      return false;
+    return true;
+  }
+
+private:
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  bool tryPush(T* item)
+  {
+    const size_t pos = write_pos_.load(std::memory_order_relaxed);
+    Cell& cell = cells_[pos % cells_.size()];
+    if (cell.sequence.load(std::memory_order_acquire) != pos)
+      return false;  // Still holds a frame from the previous lap.
+
+    cell.value = std::move(*item);
+    cell.sequence.store(pos + 1, std::memory_order_release);
+    write_pos_.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool tryPop(T* item)
+  {
+    size_t pos = read_pos_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      Cell& cell = cells_[pos % cells_.size()];
+      const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      if (sequence != pos + 1)
+      {
+        if (sequence < pos + 1)
+          return false;  // Empty.
+        pos = read_pos_.load(std::memory_order_relaxed);  // Lost the race for this cell, retry at the new head.
+        continue;
+      }
+
+      if (read_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+      {
+        *item = std::move(cell.value);
+        cell.value = T();
+        cell.sequence.store(pos + cells_.size(), std::memory_order_release);
+        return true;
+      }
+    }
+  }
+
+  std::vector<Cell> cells_;
+  const DropPolicy policy_;
+
+  std::atomic<size_t> write_pos_;
+  std::atomic<size_t> read_pos_;
+
+  std::atomic<uint64_t> pushed_;
+  std::atomic<uint64_t> dropped_;
+  std::atomic<size_t> peak_occupancy_;
+
+  std::mutex wait_mutex_;  ///< Only used to put an idle consumer to sleep, never on the data path.
+  std::condition_variable not_empty_;
+};
+}  // namespace spinnaker_camera_driver
+#endif  // SPINNAKER_CAMERA_DRIVER_FRAME_RING_H
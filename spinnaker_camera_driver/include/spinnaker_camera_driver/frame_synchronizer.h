@@ -0,0 +1,153 @@
+/**
+Software License Agreement (BSD)
+
+\file      frame_synchronizer.h
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef SPINNAKER_CAMERA_DRIVER_FRAME_SYNCHRONIZER_H
+#define SPINNAKER_CAMERA_DRIVER_FRAME_SYNCHRONIZER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace spinnaker_camera_driver
+{
+/**
+ * Matches frames from several cameras into sets that were captured together.
+ *
+ * Each frame comes with a key, either its hardware timestamp or its frame ID, and frames from different inputs
+ * match when their keys are at most the tolerance apart. Every input arrives in key order, so a frame whose key is
+ * already more than the tolerance behind the newest head of another input can never be matched and is discarded.
+ * At most capacity frames wait per input, which bounds the latency added when a camera stops delivering.
+ *
+ * Not thread safe, the caller serializes add().
+ */
+template <typename T>
+class FrameSynchronizer
+{
+public:
+  struct Statistics
+  {
+    uint64_t matched;                 ///< Complete sets emitted.
+    std::vector<uint64_t> unmatched;  ///< Frames per input discarded for lack of a partner within the tolerance.
+    std::vector<uint64_t> dropped;    ///< Frames per input discarded because too many were waiting.
+  };
+
+  FrameSynchronizer(const size_t inputs, const int64_t tolerance, const size_t capacity)
+    : queues_(inputs), tolerance_(std::max<int64_t>(tolerance, 0)), capacity_(std::max<size_t>(capacity, 1))
+  {
+    statistics_.matched = 0;
+    statistics_.unmatched.assign(inputs, 0);
+    statistics_.dropped.assign(inputs, 0);
+  }
+
+  /*!
+  * \brief Adds a frame and collects the sets it completes.
+  *
+  * \param input Index of the camera the frame comes from.
+  * \param key Timestamp or frame ID of the frame, increasing from frame to frame of the same input.
+  * \param item The frame.
+  * \param sets Filled with the completed sets, each holding one frame per input in input order.
+  */
+  void add(const size_t input, const int64_t key, const T& item, std::vector<std::vector<T> >* sets)
+  {
+    std::deque<Entry>& queue = queues_[input];
+    if (!queue.empty() && key <= queue.back().first)
+    {
+      // The camera restarted or its clock jumped back, nothing waiting in this input can be matched any more
+      statistics_.unmatched[input] += queue.size();
+      queue.clear();
+    }
+    queue.push_back(Entry(key, item));
+    if (queue.size() > capacity_)
+    {
+      queue.pop_front();
+      statistics_.dropped[input]++;
+    }
+
+    match(sets);
+  }
+
+  size_t inputs() const
+  {
+    return queues_.size();
+  }
+
+  int64_t tolerance() const
+  {
+    return tolerance_;
+  }
+
+  const Statistics& statistics() const
+  {
+    return statistics_;
+  }
+
+private:
+  typedef std::pair<int64_t, T> Entry;
+
+  void match(std::vector<std::vector<T> >* sets)
+  {
+    for (;;)
+    {
+      int64_t newest_head = 0;
+      for (size_t i = 0; i < queues_.size(); ++i)
+      {
+        if (queues_[i].empty())
+          return;
+        newest_head = i == 0 ? queues_[i].front().first : std::max(newest_head, queues_[i].front().first);
+      }
+
+      // Heads too far behind the newest head will never find a partner
+      bool complete = true;
+      for (size_t i = 0; i < queues_.size(); ++i)
+      {
+        if (queues_[i].front().first < newest_head - tolerance_)
+        {
+          queues_[i].pop_front();
+          statistics_.unmatched[i]++;
+          complete = false;
+        }
+      }
+      if (!complete)
+        continue;
+
+      std::vector<T> set;
+      set.reserve(queues_.size());
+      for (std::deque<Entry>& queue : queues_)
+      {
+        set.push_back(std::move(queue.front().second));
+        queue.pop_front();
+      }
+      sets->push_back(std::move(set));
+      statistics_.matched++;
+    }
+  }
+
+  std::vector<std::deque<Entry> > queues_;  ///< Frames waiting for a partner, per input and in key order.
+  const int64_t tolerance_;
+  const size_t capacity_;
+  Statistics statistics_;
+};
+}  // namespace spinnaker_camera_driver
+#endif  // SPINNAKER_CAMERA_DRIVER_FRAME_SYNCHRONIZER_H
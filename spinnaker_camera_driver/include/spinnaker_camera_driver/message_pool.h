@@ -0,0 +1,150 @@
+/**
+Software License Agreement (BSD)
+
+\file      message_pool.h
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef SPINNAKER_CAMERA_DRIVER_MESSAGE_POOL_H
+#define SPINNAKER_CAMERA_DRIVER_MESSAGE_POOL_H
+
+#include <boost/shared_ptr.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace spinnaker_camera_driver
+{
+/**
+ * Pool of messages that are recycled once every subscriber has released them.
+ *
+ * acquire() hands out a message whose deleter puts it back in the pool instead of freeing it, so a message keeps
+ * the allocations of its vectors (most importantly the image data) from one frame to the next. Recycled messages are
+ * not cleared, the caller is expected to overwrite every field it uses. Messages may safely outlive the pool.
+ */
+template <typename T>
+class MessagePool
+{
+public:
+  typedef boost::shared_ptr<T> Ptr;
+
+  explicit MessagePool(const size_t capacity) : impl_(std::make_shared<Impl>(capacity))
+  {
+  }
+
+  /// Returns a recycled message if one is available, otherwise allocates a new one.
+  Ptr acquire()
+  {
+    T* message = nullptr;
+    {
+      std::lock_guard<std::mutex> scopedLock(impl_->mutex);
+      if (!impl_->free.empty())
+      {
+        message = impl_->free.back();
+        impl_->free.pop_back();
+      }
+    }
+
+    if (message)
+    {
+      impl_->hits.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+      impl_->misses.fetch_add(1, std::memory_order_relaxed);
+      message = new T;
+    }
+    return Ptr(message, Recycler(impl_));
+  }
+
+  size_t capacity() const
+  {
+    return impl_->capacity;
+  }
+
+  /// Number of messages waiting to be reused.
+  size_t available() const
+  {
+    std::lock_guard<std::mutex> scopedLock(impl_->mutex);
+    return impl_->free.size();
+  }
+
+  /// Number of acquire() calls served by a recycled message.
+  uint64_t hits() const
+  {
+    return impl_->hits.load(std::memory_order_relaxed);
+  }
+
+  /// Number of acquire() calls that had to allocate.
+  uint64_t misses() const
+  {
+    return impl_->misses.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Impl
+  {
+    explicit Impl(const size_t capacity) : capacity(capacity), hits(0), misses(0)
+    {
+      free.reserve(capacity);
+    }
+
+    ~Impl()
+    {
+      for (T* message : free)
+        delete message;
+    }
+
+    const size_t capacity;
+    std::mutex mutex;
+    std::vector<T*> free;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+  };
+
+  /// Deleter that returns the message to the pool, or frees it if the pool is already full.
+  struct Recycler
+  {
+    explicit Recycler(const std::shared_ptr<Impl>& impl) : impl(impl)
+    {
+    }
+
+    void operator()(T* message)
+    {
+      {
+        std::lock_guard<std::mutex> scopedLock(impl->mutex);
+        if (impl->free.size() < impl->capacity)
+        {
+          impl->free.push_back(message);
+          return;
+        }
+      }
+      delete message;
+    }
+
+    std::shared_ptr<Impl> impl;  ///< Keeps the pool alive for as long as any of its messages.
+  };
+
+  std::shared_ptr<Impl> impl_;
+};
+}  // namespace spinnaker_camera_driver
+#endif  // SPINNAKER_CAMERA_DRIVER_MESSAGE_POOL_H
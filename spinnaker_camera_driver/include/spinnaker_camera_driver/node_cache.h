@@ -0,0 +1,122 @@
+/**
+Software License Agreement (BSD)
+
+\file      node_cache.h
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef SPINNAKER_CAMERA_DRIVER_NODE_CACHE_H
+#define SPINNAKER_CAMERA_DRIVER_NODE_CACHE_H
+
+// Spinnaker SDK
+#include "Spinnaker.h"
+#include "SpinGenApi/SpinnakerGenApi.h"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace spinnaker_camera_driver
+{
+/**
+ * Looks up the nodes of a GenICam node map by name once and hands out the cached handles afterwards.
+ *
+ * Looking up a node by name goes through the node map every time, which adds up when every reconfiguration and every
+ * diagnostics cycle touches dozens of properties. A node handle stays valid as long as the camera is initialized, so
+ * a cache must not outlive the connection it was created for. Only the handles are cached: whether a node is
+ * currently writable and its current limits depend on other settings and are still read from the node itself.
+ * Names the node map does not know are cached as null handles as well.
+ *
+ * probe() additionally records what the features the driver uses support, once per connection. Whether a feature or
+ * an enumeration entry is implemented at all never changes while connected, so features and entries the camera lacks
+ * can be rejected without going back to it. Availability, access mode and limits are recorded as they were at probe
+ * time and only serve as a first guess.
+ */
+class NodeCache
+{
+public:
+  /// What a feature supported when the node map was probed.
+  struct Capability
+  {
+    Spinnaker::GenApi::EInterfaceType type;  ///< Principal interface type, e.g. intfIFloat.
+    bool implemented;                        ///< Whether the camera has the feature at all.
+    bool available;                          ///< Available at probe time, this can change with other settings.
+    bool writable;                           ///< Writable at probe time, this can change with other settings.
+    bool has_range;                          ///< Whether min and max were read, for integer and float features.
+    double min;
+    double max;
+    std::vector<std::string> entries;  ///< Implemented entries of an enumeration.
+  };
+
+  explicit NodeCache(Spinnaker::GenApi::INodeMap* node_map);
+
+  /// Records the capabilities of the named features, replacing earlier ones.
+  void probe(const std::vector<std::string>& names);
+
+  /// Returns false if the feature was not probed.
+  bool getCapability(const std::string& name, Capability* capability) const;
+
+  /// Capabilities of all probed features, sorted by name.
+  std::vector<std::pair<std::string, Capability> > getCapabilities() const;
+
+  /// Whether a feature is available, answered from the probe for features the camera does not implement.
+  bool isAvailable(const Spinnaker::GenICam::gcstring& name);
+
+  /// Whether the camera has a feature at all, from the probe where there is one.
+  bool isImplemented(const Spinnaker::GenICam::gcstring& name);
+
+  /// Whether a feature can be written at the moment.
+  bool isWritable(const Spinnaker::GenICam::gcstring& name);
+
+  /// Reads an integer feature. Returns false, leaving value alone, if it is not available or readable.
+  bool readInteger(const Spinnaker::GenICam::gcstring& name, int64_t* value);
+
+  /// Reads a float feature. Returns false, leaving value alone, if it is not available or readable.
+  bool readFloat(const Spinnaker::GenICam::gcstring& name, double* value);
+
+  /// Returns the node, only going through the node map the first time a name is asked for.
+  Spinnaker::GenApi::CNodePtr getNode(const Spinnaker::GenICam::gcstring& name);
+
+  /// Identifies the node map in log messages, from DeviceID or for the stream node map StreamID.
+  const std::string& id();
+
+  /// Node map lookups so far, one per distinct name.
+  uint64_t lookups() const;
+
+  /// Requests served from the cache so far.
+  uint64_t hits() const;
+
+private:
+  Spinnaker::GenApi::CNodePtr lookup(const std::string& name);
+
+  Spinnaker::GenApi::INodeMap* node_map_;
+
+  mutable std::mutex mutex_;  ///< The configuration, acquisition and diagnostics threads share the cache.
+  std::unordered_map<std::string, Spinnaker::GenApi::CNodePtr> nodes_;
+  std::map<std::string, Capability> capabilities_;
+  std::string id_;
+  uint64_t lookups_;
+  uint64_t hits_;
+};
+}  // namespace spinnaker_camera_driver
+#endif  // SPINNAKER_CAMERA_DRIVER_NODE_CACHE_H
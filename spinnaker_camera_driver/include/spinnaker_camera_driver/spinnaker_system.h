@@ -0,0 +1,172 @@
+/**
+Software License Agreement (BSD)
+
+\file      spinnaker_system.h
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef SPINNAKER_CAMERA_DRIVER_SPINNAKER_SYSTEM_H
+#define SPINNAKER_CAMERA_DRIVER_SPINNAKER_SYSTEM_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Spinnaker SDK
+#include "Spinnaker.h"
+
+namespace spinnaker_camera_driver
+{
+/**
+ * The Spinnaker system and its camera list, shared by every SpinnakerCamera in the process.
+ *
+ * Enumerating the cameras scans every bus, so doing it once per camera slows down starting rigs with many cameras.
+ * The instance is created by the first camera that needs it and released with the last one. It also bounds how many
+ * cameras connect and configure at the same time, since those steps are slow for each camera but overloading the
+ * buses with them makes every camera slower.
+ *
+ * Cameras arriving and leaving are reported by Spinnaker interface events, so that a camera that dropped off the bus
+ * can be reconnected as soon as it comes back instead of on the next poll.
+ */
+class SpinnakerSystem
+{
+public:
+  /// Returns the shared instance, creating it and enumerating the cameras if no one holds it yet.
+  static std::shared_ptr<SpinnakerSystem> instance();
+
+  ~SpinnakerSystem();
+
+  /*!
+  * \brief Looks up a camera in the list.
+  *
+  * \param serial Serial number of the camera, or an empty string for the first camera found.
+  * \return The camera, which is not valid if there is no such camera.
+  */
+  Spinnaker::CameraPtr getCamera(const std::string& serial);
+
+  /// Enumerates the cameras again, e.g. after one was disconnected.
+  void refresh();
+
+  /// Number of device arrivals seen so far, on any interface.
+  uint64_t arrivals();
+
+  /// Number of times the camera with the given serial number was seen leaving.
+  uint64_t removals(const uint64_t serial);
+
+  /*!
+  * \brief Waits for a device to arrive.
+  *
+  * \param seen Value of arrivals() already accounted for, any arrival after that ends the wait.
+  * \param timeout Longest time to wait.
+  * \return true if a device arrived, false on timeout.
+  */
+  bool waitForArrival(const uint64_t seen, const std::chrono::milliseconds& timeout);
+
+  unsigned int numCameras();
+
+  Spinnaker::SystemPtr system()
+  {
+    return system_;
+  }
+
+  /// Limits how many cameras may hold a connect slot at once, 0 for no limit.
+  void setMaxParallelConnects(const size_t max_parallel_connects);
+
+  /*!
+  * \brief Waits until a connect slot is free and takes it.
+  *
+  * Throws boost::thread_interrupted if the calling boost::thread is interrupted while waiting.
+  */
+  void acquireConnectSlot();
+
+  void releaseConnectSlot();
+
+  /// Holds a connect slot for as long as it exists.
+  class ConnectSlot
+  {
+  public:
+    explicit ConnectSlot(const std::shared_ptr<SpinnakerSystem>& system) : system_(system)
+    {
+      system_->acquireConnectSlot();
+    }
+
+    ~ConnectSlot()
+    {
+      system_->releaseConnectSlot();
+    }
+
+  private:
+    ConnectSlot(const ConnectSlot&);
+    ConnectSlot& operator=(const ConnectSlot&);
+
+    std::shared_ptr<SpinnakerSystem> system_;
+  };
+
+private:
+  /// Forwards the interface events Spinnaker raises on its own thread.
+  class DeviceEventHandler : public Spinnaker::InterfaceEvent
+  {
+  public:
+    explicit DeviceEventHandler(SpinnakerSystem* system) : system_(system)
+    {
+    }
+
+    void OnDeviceArrival(uint64_t serial)
+    {
+      system_->onDeviceArrival(serial);
+    }
+
+    void OnDeviceRemoval(uint64_t serial)
+    {
+      system_->onDeviceRemoval(serial);
+    }
+
+  private:
+    SpinnakerSystem* system_;
+  };
+
+  SpinnakerSystem();
+
+  void onDeviceArrival(const uint64_t serial);
+  void onDeviceRemoval(const uint64_t serial);
+
+  std::mutex mutex_;  ///< Serializes access to the camera list between cameras.
+  Spinnaker::SystemPtr system_;
+  Spinnaker::CameraList cameras_;
+
+  std::mutex connect_mutex_;
+  std::condition_variable connect_slot_released_;
+  size_t max_parallel_connects_;  ///< 0 for no limit.
+  size_t connecting_;             ///< Connect slots currently taken.
+
+  std::mutex event_mutex_;
+  std::condition_variable device_arrived_;
+  /// Whether cameras_ was enumerated before the latest event. Not under mutex_, events are raised while it is held.
+  std::atomic<bool> cameras_stale_;
+  uint64_t arrivals_;                   ///< Device arrivals so far.
+  std::map<uint64_t, uint64_t> removals_;  ///< Device removals so far, by serial number.
+  DeviceEventHandler event_handler_;
+};
+}  // namespace spinnaker_camera_driver
+#endif  // SPINNAKER_CAMERA_DRIVER_SPINNAKER_SYSTEM_H
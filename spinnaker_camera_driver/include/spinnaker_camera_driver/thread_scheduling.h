@@ -0,0 +1,67 @@
+/**
+Software License Agreement (BSD)
+
+\file      thread_scheduling.h
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef SPINNAKER_CAMERA_DRIVER_THREAD_SCHEDULING_H
+#define SPINNAKER_CAMERA_DRIVER_THREAD_SCHEDULING_H
+
+#include <string>
+#include <vector>
+
+namespace spinnaker_camera_driver
+{
+/*!
+* \brief Pins the calling thread to the given CPUs.
+*
+* \param cpus CPU indices, an empty list leaves the affinity untouched.
+* \param error Set to the reason on failure.
+* \return false if the affinity could not be changed.
+*/
+bool setCurrentThreadAffinity(const std::vector<int>& cpus, std::string* error);
+
+/*!
+* \brief Switches the calling thread to SCHED_FIFO.
+*
+* \param priority SCHED_FIFO priority, 0 leaves the thread on its current policy.
+* \param error Set to the reason on failure, typically missing CAP_SYS_NICE or an RLIMIT_RTPRIO of 0.
+* \return false if the policy could not be changed.
+*/
+bool setCurrentThreadRealtime(const int priority, std::string* error);
+
+/*!
+* \brief Locks all current and future pages of the process into memory.
+*
+* This affects the whole process, including any other nodelets loaded into the same manager. When the process is
+* bound by RLIMIT_MEMLOCK the lock is refused up front, because every allocation beyond the limit would fail
+* afterwards.
+* \param error Set to the reason on failure.
+* \return false if the memory was not locked.
+*/
+bool lockProcessMemory(std::string* error);
+
+/// Describes the scheduling policy, priority and CPU affinity the calling thread actually has.
+std::string describeCurrentThreadScheduling();
+
+/// CPU time consumed by the calling thread so far, in seconds.
+double currentThreadCpuTime();
+}  // namespace spinnaker_camera_driver
+#endif  // SPINNAKER_CAMERA_DRIVER_THREAD_SCHEDULING_H
@@ -0,0 +1,134 @@
+/**
+Software License Agreement (BSD)
+
+\file      timestamp_estimator.h
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef SPINNAKER_CAMERA_DRIVER_TIMESTAMP_ESTIMATOR_H
+#define SPINNAKER_CAMERA_DRIVER_TIMESTAMP_ESTIMATOR_H
+
+#include <ros/ros.h>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace spinnaker_camera_driver
+{
+/**
+ * Maps the camera's hardware clock onto ROS time.
+ *
+ * Each frame contributes a pair of (camera timestamp, host time at which the frame was received). The drift between
+ * the clocks is fitted by least squares over the least delayed samples of the last few windows of frames.
+ *
+ * The offset between the clocks comes from an anchor when there is one: a camera timestamp latched on command, paired
+ * with the host times just before and after the command. Latching costs a round trip to the camera, so it is only
+ * meant to be done every so often, the drift fit carries the mapping in between. The host receive times of the frames
+ * then give the transport latency rather than the offset.
+ *
+ * Without an anchor, the offset is taken from the least delayed frame in a sliding window, minus a configured
+ * latency. Host times only ever arrive late, so this is better than an average, but every stamp is still late by
+ * whatever part of the readout and transport latency the configured latency does not cover.
+ *
+ * Remaining bias: the mapped stamp is the camera's own frame timestamp, which depending on the model marks the start
+ * or the end of the exposure. With an anchor it is off by at most half the round trip of the latch command, which is
+ * reported as the anchor uncertainty, plus the drift accumulated since the anchor. Both clocks must count
+ * nanoseconds.
+ */
+class TimestampEstimator
+{
+public:
+  struct Statistics
+  {
+    size_t samples;             ///< Samples currently in the fit window.
+    double residual_rms;        ///< RMS delay of the samples above the mapped line, in seconds.
+    double residual_max;        ///< Largest delay of a sample above the mapped line, in seconds.
+    double drift_ppm;           ///< Rate of the camera clock relative to ROS time, in parts per million.
+    uint64_t resets;            ///< Number of times the camera clock was seen to jump backwards.
+    bool anchored;              ///< Whether the offset comes from a latched timestamp.
+    double anchor_uncertainty;  ///< Half the round trip of the last latch, in seconds.
+    double latency;             ///< Least receive delay after the mapped stamp in seconds, with an anchor.
+  };
+
+  /*!
+  * \param window_size Number of frames the offset and each drift fit sample are taken over.
+  * \param latency Seconds subtracted from the least delayed receive time while there is no anchor.
+  */
+  explicit TimestampEstimator(const size_t window_size, const double latency = 0.0);
+
+  /*!
+  * \brief Adds a sample and maps its camera timestamp onto ROS time.
+  *
+  * \param camera_stamp Camera timestamp of the frame, in nanoseconds.
+  * \param host_stamp ROS time at which the frame was received.
+  * \return The mapped stamp, or host_stamp while there are too few samples for a fit.
+  */
+  ros::Time update(const uint64_t camera_stamp, const ros::Time& host_stamp);
+
+  /*!
+  * \brief Anchors the offset between the clocks to a camera timestamp latched on command.
+  *
+  * \param camera_stamp The latched camera timestamp, in nanoseconds.
+  * \param host_before ROS time just before the latch command was sent.
+  * \param host_after ROS time just after it returned.
+  */
+  void anchor(const uint64_t camera_stamp, const ros::Time& host_before, const ros::Time& host_after);
+
+  /// Discards all samples and the anchor, e.g. after reconnecting to a camera whose clock may have restarted.
+  void reset();
+
+  Statistics statistics() const;
+
+private:
+  struct Sample
+  {
+    double camera;  ///< Seconds since reference_camera_.
+    double host;    ///< Seconds since reference_host_.
+  };
+
+  void clear();
+  void fitDrift();
+  void setReference(const uint64_t camera_stamp, const ros::Time& host_stamp);
+  double cameraSeconds(const uint64_t camera_stamp) const;
+
+  const size_t window_size_;
+  const double latency_;
+  std::deque<Sample> samples_;
+
+  // Least delayed sample of each completed window, used to fit the drift.
+  std::deque<Sample> minima_;
+  Sample block_minimum_;
+  size_t block_count_;
+
+  bool has_reference_;
+  uint64_t reference_camera_;
+  ros::Time reference_host_;
+  uint64_t last_camera_;
+
+  double slope_;  ///< Fitted rate of ROS time per unit of camera time.
+
+  bool has_anchor_;
+  Sample anchor_;  ///< Latched camera time and the host time in the middle of the latch command.
+
+  Statistics statistics_;
+  mutable std::mutex mutex_;
+};
+}  // namespace spinnaker_camera_driver
+#endif  // SPINNAKER_CAMERA_DRIVER_TIMESTAMP_ESTIMATOR_H
@@ -0,0 +1,53 @@
+/**
+Software License Agreement (BSD)
+
+\file      user_set.h
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef SPINNAKER_CAMERA_DRIVER_USER_SET_H
+#define SPINNAKER_CAMERA_DRIVER_USER_SET_H
+
+// Header generated by dynamic_reconfigure
+#include <spinnaker_camera_driver/SpinnakerConfig.h>
+
+#include <cstdint>
+#include <string>
+
+namespace spinnaker_camera_driver
+{
+/*!
+* \brief Fingerprint of a configuration, to tell whether a camera UserSet still holds it.
+*
+* Covers every parameter of the configuration plus salt, which should identify what else the stored settings depend
+* on, such as the UserSet name and the camera firmware. The hash is stable across processes and builds.
+*/
+uint64_t hashConfiguration(const spinnaker_camera_driver::SpinnakerConfig& config, const std::string& salt);
+
+/*!
+* \brief Reads the configuration hash saved along with a UserSet.
+*
+* \return false if the file does not exist, cannot be parsed or was written for a different UserSet.
+*/
+bool readUserSetHash(const std::string& path, const std::string& user_set, uint64_t* hash);
+
+/// Records the hash of the configuration just saved into user_set, returns whether the file could be written.
+bool writeUserSetHash(const std::string& path, const std::string& user_set, uint64_t hash);
+}  // namespace spinnaker_camera_driver
+#endif  // SPINNAKER_CAMERA_DRIVER_USER_SET_H
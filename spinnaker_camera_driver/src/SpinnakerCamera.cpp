@@ -42,10 +42,14 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "spinnaker_camera_driver/SpinnakerCamera.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <sstream>
 #include <typeinfo>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <ros/ros.h>
 
@@ -53,41 +57,59 @@ namespace spinnaker_camera_driver
 {
 SpinnakerCamera::SpinnakerCamera()
   : serial_(0)
-  , system_(Spinnaker::System::GetInstance())
-  , camList_(system_->GetCameras())
+  , system_(SpinnakerSystem::instance())
   , pCam_(static_cast<int>(NULL))  // Hack to suppress compiler warning. Spinnaker has only one contructor which takes
                                    // an int
   , camera_(static_cast<int>(NULL))
   , captureRunning_(false)
+  , timeout_(1000)
+  , fixed_timeout_(0.0)
+  , trigger_enabled_(false)
+  , roi_statistics_()
+  , stream_configured_(false)
+  , encoding_valid_(false)
+  , restart_once_auto_modes_(false)
 {
-  unsigned int num_cameras = camList_.GetSize();
-  ROS_INFO_STREAM_ONCE("[SpinnakerCamera]: Number of cameras detected: " << num_cameras);
 }
 
 SpinnakerCamera::~SpinnakerCamera()
 {
-  camList_.Clear();
-  system_->ReleaseInstance();
+  // Let go of the camera before the shared system may be released along with system_
+  pCam_ = static_cast<int>(NULL);
 }
 
 void SpinnakerCamera::setNewConfiguration(const spinnaker_camera_driver::SpinnakerConfig& config, const uint32_t& level)
 {
-  // Check if camera is connected
+  // Connecting is left to the caller, which bounds how many cameras connect at once
   if (!pCam_)
   {
-    SpinnakerCamera::connect();
+    throw std::runtime_error("[SpinnakerCamera::setNewConfiguration] Not connected to the camera.");
   }
 
   // Activate mutex to prevent us from grabbing images during this time
   std::lock_guard<std::mutex> scopedLock(mutex_);
 
-  if (level >= LEVEL_RECONFIGURE_STOP)
+  uint64_t lookups_before = 0;
+  uint64_t hits_before = 0;
+  getNodeCacheStatistics(&lookups_before, &hits_before);
+
+  // Stop-level parameters are only locked while streaming if they actually change, everything else is applied live.
+  // After a failed configuration nothing is known to be on the camera, so the next one is written whole whatever its
+  // level, otherwise a rejected image format would never be retried.
+  const bool stream_changed = streamConfigChanged(config);
+  const bool write_all = !camera_->hasAppliedConfiguration();
+  if ((level >= LEVEL_RECONFIGURE_STOP || write_all) && (stream_changed || camera_->needsAcquisitionStop(config)))
   {
     ROS_DEBUG("SpinnakerCamera::setNewConfiguration: Reconfigure Stop.");
+    const uint32_t stop_level = std::max<uint32_t>(level, LEVEL_RECONFIGURE_STOP);
     bool capture_was_running = captureRunning_;
-    start();  // For some reason some params only work after aquisition has be started once.
     stop();
-    camera_->setNewConfiguration(config, level);
+    if (stream_changed)
+      configureStream(config);
+    if (!user_set_.empty() && write_all)
+      applyUserSet(config, stop_level);
+    else
+      camera_->setNewConfiguration(config, stop_level);
     if (capture_was_running)
       start();
   }
@@ -95,51 +117,114 @@ void SpinnakerCamera::setNewConfiguration(const spinnaker_camera_driver::Spinnak
   {
     camera_->setNewConfiguration(config, level);
   }
+  updateTimeout(config);
+
+  uint64_t lookups = 0;
+  uint64_t hits = 0;
+  getNodeCacheStatistics(&lookups, &hits);
+  ROS_DEBUG("[SpinnakerCamera]: Reconfigure looked up %lu nodes in the node map, served %lu from the cache",
+            static_cast<unsigned long>(lookups - lookups_before), static_cast<unsigned long>(hits - hits_before));
 }  // end setNewConfiguration
 
 void SpinnakerCamera::setROI(const int x_offset, const int y_offset, const int roi_width, const int roi_height)
 {
+  const ros::WallTime update_start = ros::WallTime::now();
+
   // Activate mutex to prevent us from grabbing images during this time
   std::lock_guard<std::mutex> scopedLock(mutex_);
 
-  if (camera_)
+  if (!camera_)
+    return;
+
+  // Moving the ROI is applied while streaming. Only a size the camera will not take while streaming stops
+  // acquisition, for no longer than it takes to write the ROI.
+  const bool need_restart = captureRunning_ && camera_->roiNeedsAcquisitionStop(roi_width, roi_height);
+  double blackout = 0.0;
+  double frame_rate = 0.0;
+  if (need_restart)
+  {
+    Spinnaker::GenApi::CFloatPtr frame_rate_ptr = node_cache_->getNode("AcquisitionResultingFrameRate");
+    if (!trigger_enabled_ && IsAvailable(frame_rate_ptr) && IsReadable(frame_rate_ptr))
+      frame_rate = frame_rate_ptr->GetValue();
+
+    const ros::WallTime stop_start = ros::WallTime::now();
+    stop();
+    try
+    {
+      camera_->setROI(x_offset, y_offset, roi_width, roi_height);
+    }
+    catch (...)
+    {
+      // Keep streaming with the old ROI rather than leave acquisition stopped
+      start();
+      throw;
+    }
+    start();
+    blackout = (ros::WallTime::now() - stop_start).toSec();
+  }
+  else
   {
-    bool need_restart = (captureRunning_ && \
-                         (roi_width != camera_->getROIWidth() || \
-                          roi_height != camera_->getROIHeight()));
-    if (need_restart) stop();
     camera_->setROI(x_offset, y_offset, roi_width, roi_height);
-    if (need_restart) start();
   }
+
+  const double latency = (ros::WallTime::now() - update_start).toSec();
+  std::lock_guard<std::mutex> statisticsLock(roi_statistics_mutex_);
+  roi_statistics_.updates++;
+  roi_statistics_.last_latency = latency;
+  roi_statistics_.max_latency = std::max(roi_statistics_.max_latency, latency);
+  if (need_restart)
+  {
+    roi_statistics_.restarts++;
+    roi_statistics_.last_blackout = blackout;
+    roi_statistics_.frames_lost += static_cast<uint64_t>(std::ceil(blackout * frame_rate));
+  }
+}
+
+SpinnakerCamera::RoiStatistics SpinnakerCamera::getRoiStatistics() const
+{
+  std::lock_guard<std::mutex> statisticsLock(roi_statistics_mutex_);
+  return roi_statistics_;
 }
 
 void SpinnakerCamera::setGain(const float& gain)
 {
+  // The configuration Camera keeps is shared with setNewConfiguration
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+
   if (camera_)
     camera_->setGain(gain);
 }
 
 int SpinnakerCamera::getHeightMax()
 {
-  if (camera_)
-    return camera_->getHeightMax();
+  std::shared_ptr<Camera> camera;
+  getHandles(&camera, nullptr, nullptr);
+  if (camera)
+    return camera->getHeightMax();
   else
     return 0;
 }
 
 int SpinnakerCamera::getWidthMax()
 {
-  if (camera_)
-    return camera_->getWidthMax();
+  std::shared_ptr<Camera> camera;
+  getHandles(&camera, nullptr, nullptr);
+  if (camera)
+    return camera->getWidthMax();
   else
     return 0;
 }
 
 Spinnaker::GenApi::CNodePtr SpinnakerCamera::readProperty(const Spinnaker::GenICam::gcstring property_name)
 {
-  if (camera_)
+  // The diagnostics thread reads properties while the acquisition thread may reconnect, the copies keep the Camera
+  // and the node cache it uses alive until the read is done
+  std::shared_ptr<Camera> camera;
+  std::shared_ptr<NodeCache> node_cache;
+  getHandles(&camera, &node_cache, nullptr);
+  if (camera)
   {
-    return camera_->readProperty(property_name);
+    return camera->readProperty(property_name);
   }
   else
   {
@@ -147,10 +232,193 @@ Spinnaker::GenApi::CNodePtr SpinnakerCamera::readProperty(const Spinnaker::GenIC
   }
 }
 
+Spinnaker::GenApi::CNodePtr SpinnakerCamera::readStreamProperty(const Spinnaker::GenICam::gcstring property_name)
+{
+  std::shared_ptr<NodeCache> stream_node_cache;
+  getHandles(nullptr, nullptr, &stream_node_cache);
+  if (!stream_node_cache)
+    return 0;
+
+  // Which stream counters exist depends on the transport layer, so an unavailable one is not an error
+  Spinnaker::GenApi::CNodePtr ptr = stream_node_cache->getNode(property_name);
+  if (!Spinnaker::GenApi::IsAvailable(ptr) || !Spinnaker::GenApi::IsReadable(ptr))
+    return 0;
+  return ptr;
+}
+
+void SpinnakerCamera::configureStream(const spinnaker_camera_driver::SpinnakerConfig& config)
+{
+  // The stream node map lives on the host and can only be changed while the camera is not acquiring
+  ConfigTransaction transaction(stream_node_cache_.get());
+  transaction.set("StreamBufferCountMode", config.stream_buffer_count_mode);
+  if (config.stream_buffer_count_mode == "Manual")
+    transaction.set("StreamBufferCountManual", config.stream_buffer_count_manual);
+  transaction.set("StreamBufferHandlingMode", config.stream_buffer_handling_mode);
+  transaction.commit();
+  stream_config_ = config;
+  stream_configured_ = true;
+}
+
+void SpinnakerCamera::setUserSet(const std::string& user_set, const std::string& hash_path)
+{
+  user_set_ = user_set;
+  user_set_hash_path_ = hash_path;
+}
+
+void SpinnakerCamera::applyUserSet(const spinnaker_camera_driver::SpinnakerConfig& config, const uint32_t& level)
+{
+  // The hash file may have been written for another camera, and other firmware may store different settings
+  std::string salt = user_set_;
+  for (const char* property_name : { "DeviceSerialNumber", "DeviceFirmwareVersion" })
+  {
+    Spinnaker::GenApi::CStringPtr string_ptr = node_cache_->getNode(property_name);
+    if (Spinnaker::GenApi::IsAvailable(string_ptr) && Spinnaker::GenApi::IsReadable(string_ptr))
+      salt += std::string("/") + string_ptr->GetValue().c_str();
+  }
+  const uint64_t hash = hashConfiguration(config, salt);
+
+  uint64_t stored_hash = 0;
+  if (readUserSetHash(user_set_hash_path_, user_set_, &stored_hash) && stored_hash == hash && loadUserSet())
+  {
+    camera_->configurationLoaded(config);
+    ROS_INFO("[SpinnakerCamera]: Loaded the configuration from %s", user_set_.c_str());
+    return;
+  }
+
+  camera_->setNewConfiguration(config, level);
+  if (saveUserSet())
+  {
+    if (writeUserSetHash(user_set_hash_path_, user_set_, hash))
+      ROS_INFO("[SpinnakerCamera]: Saved the configuration to %s", user_set_.c_str());
+    else
+      ROS_WARN("[SpinnakerCamera]: Could not write %s, the configuration will be written again on the next connect",
+               user_set_hash_path_.c_str());
+  }
+}
+
+bool SpinnakerCamera::loadUserSet()
+{
+  try
+  {
+    ConfigTransaction transaction(node_cache_.get());
+    transaction.set("UserSetSelector", user_set_);
+    transaction.commit();
+
+    Spinnaker::GenApi::CCommandPtr load_ptr = node_cache_->getNode("UserSetLoad");
+    if (!Spinnaker::GenApi::IsAvailable(load_ptr) || !Spinnaker::GenApi::IsWritable(load_ptr))
+    {
+      ROS_WARN("[SpinnakerCamera]: UserSetLoad is not available, writing the configuration instead");
+      return false;
+    }
+    load_ptr->Execute();
+    return true;
+  }
+  catch (const Spinnaker::Exception& e)
+  {
+    ROS_WARN("[SpinnakerCamera]: Failed to load %s, writing the configuration instead: %s", user_set_.c_str(),
+             e.what());
+    return false;
+  }
+}
+
+bool SpinnakerCamera::saveUserSet()
+{
+  try
+  {
+    ConfigTransaction transaction(node_cache_.get());
+    transaction.set("UserSetSelector", user_set_);
+    transaction.commit();
+
+    Spinnaker::GenApi::CCommandPtr save_ptr = node_cache_->getNode("UserSetSave");
+    if (!Spinnaker::GenApi::IsAvailable(save_ptr) || !Spinnaker::GenApi::IsWritable(save_ptr))
+    {
+      ROS_WARN("[SpinnakerCamera]: UserSetSave is not available, the configuration is not saved");
+      return false;
+    }
+    save_ptr->Execute();
+
+    // Also start up with it after a power cycle. Older models name the node UserSetDefaultSelector.
+    ConfigTransaction default_transaction(node_cache_.get());
+    if (Spinnaker::GenApi::IsAvailable(node_cache_->getNode("UserSetDefault")))
+      default_transaction.set("UserSetDefault", user_set_);
+    else
+      default_transaction.set("UserSetDefaultSelector", user_set_);
+    default_transaction.commit();
+    return true;
+  }
+  catch (const Spinnaker::Exception& e)
+  {
+    ROS_WARN("[SpinnakerCamera]: Failed to save the configuration to %s: %s", user_set_.c_str(), e.what());
+    return false;
+  }
+}
+
+bool SpinnakerCamera::streamConfigChanged(const spinnaker_camera_driver::SpinnakerConfig& config) const
+{
+  return !stream_configured_ || config.stream_buffer_count_mode != stream_config_.stream_buffer_count_mode ||
+         config.stream_buffer_count_manual != stream_config_.stream_buffer_count_manual ||
+         config.stream_buffer_handling_mode != stream_config_.stream_buffer_handling_mode;
+}
+
+void SpinnakerCamera::getNodeCacheStatistics(uint64_t* lookups, uint64_t* hits) const
+{
+  std::shared_ptr<NodeCache> node_cache;
+  std::shared_ptr<NodeCache> stream_node_cache;
+  getHandles(nullptr, &node_cache, &stream_node_cache);
+
+  *lookups = 0;
+  *hits = 0;
+  for (const NodeCache* cache : { node_cache.get(), stream_node_cache.get() })
+  {
+    if (!cache)
+      continue;
+    *lookups += cache->lookups();
+    *hits += cache->hits();
+  }
+}
+
+std::vector<std::pair<std::string, NodeCache::Capability> > SpinnakerCamera::getCapabilities() const
+{
+  std::shared_ptr<NodeCache> node_cache;
+  getHandles(nullptr, &node_cache, nullptr);
+  if (!node_cache)
+    return std::vector<std::pair<std::string, NodeCache::Capability> >();
+  return node_cache->getCapabilities();
+}
+
+void SpinnakerCamera::getHandles(std::shared_ptr<Camera>* camera, std::shared_ptr<NodeCache>* node_cache,
+                                 std::shared_ptr<NodeCache>* stream_node_cache) const
+{
+  std::lock_guard<std::mutex> handlesLock(handles_mutex_);
+  if (camera)
+    *camera = camera_;
+  if (node_cache)
+    *node_cache = node_cache_;
+  if (stream_node_cache)
+    *stream_node_cache = stream_node_cache_;
+}
+
+void SpinnakerCamera::setHandles(const std::shared_ptr<Camera>& camera, const std::shared_ptr<NodeCache>& node_cache,
+                                 const std::shared_ptr<NodeCache>& stream_node_cache)
+{
+  std::lock_guard<std::mutex> handlesLock(handles_mutex_);
+  camera_ = camera;
+  node_cache_ = node_cache;
+  stream_node_cache_ = stream_node_cache;
+}
+
 void SpinnakerCamera::connect()
 {
   if (!pCam_)
   {
+    connect_times_.clear();
+    ros::WallTime stage_start = ros::WallTime::now();
+    auto stageDone = [this, &stage_start](const std::string& stage) {
+      const ros::WallTime now = ros::WallTime::now();
+      connect_times_.push_back(std::make_pair(stage, (now - stage_start).toSec()));
+      stage_start = now;
+    };
+
     // If we have a specific camera to connect to (specified by a serial number)
     if (serial_ != 0)
     {
@@ -158,7 +426,7 @@ void SpinnakerCamera::connect()
 
       try
       {
-        pCam_ = camList_.GetBySerial(serial_string);
+        pCam_ = system_->getCamera(serial_string);
       }
       catch (const Spinnaker::Exception& e)
       {
@@ -171,7 +439,7 @@ void SpinnakerCamera::connect()
       // Connect to any camera (the first)
       try
       {
-        pCam_ = camList_.GetByIndex(0);
+        pCam_ = system_->getCamera("");
       }
       catch (const Spinnaker::Exception& e)
       {
@@ -183,6 +451,7 @@ void SpinnakerCamera::connect()
     {
       throw std::runtime_error("[SpinnakerCamera::connect] Failed to obtain camera reference.");
     }
+    stageDone("lookup");
 
     try
     {
@@ -229,29 +498,49 @@ void SpinnakerCamera::connect()
       throw std::runtime_error("[SpinnakerCamera::connect] Failed to determine device info with error: " +
                                std::string(e.what()));
     }
+    stageDone("device info");
 
     try
     {
       // Initialize Camera
       pCam_->Init();
+      stageDone("init");
 
-      // Retrieve GenICam nodemap
+      // Retrieve GenICam nodemap. The caches and the Camera using them are handed out together, see setHandles.
       node_map_ = &pCam_->GetNodeMap();
+      std::shared_ptr<NodeCache> node_cache(new NodeCache(node_map_));
+      std::shared_ptr<NodeCache> stream_node_cache(new NodeCache(&pCam_->GetTLStreamNodeMap()));
+      stream_configured_ = false;
+      stageDone("node map");
 
       // detect model and set camera_ accordingly;
-      Spinnaker::GenApi::CStringPtr model_name = node_map_->GetNode("DeviceModelName");
+      Spinnaker::GenApi::CStringPtr model_name = node_cache->getNode("DeviceModelName");
       std::string model_name_str(model_name->ToString());
 
       ROS_INFO("[SpinnakerCamera::connect]: Camera model name: %s", model_name_str.c_str());
+      std::shared_ptr<Camera> camera;
       if (model_name_str.find("Blackfly S") != std::string::npos)
-        camera_.reset(new Camera(node_map_));
+        camera.reset(new Camera(node_cache.get()));
       else if (model_name_str.find("Chameleon3") != std::string::npos)
-        camera_.reset(new Cm3(node_map_));
+        camera.reset(new Cm3(node_cache.get()));
       else
       {
-        camera_.reset(new Camera(node_map_));
+        camera.reset(new Camera(node_cache.get()));
         ROS_WARN("SpinnakerCamera::connect: Could not detect camera model name.");
       }
+      {
+        // setGain, setROI and latchTimestamp use them from other threads under mutex_
+        std::lock_guard<std::mutex> scopedLock(mutex_);
+        setHandles(camera, node_cache, stream_node_cache);
+      }
+      stageDone("model setup");
+
+      // The first configuration is written before acquisition starts, start() writes its Once auto modes again
+      restart_once_auto_modes_ = true;
+
+      // Record once what the features the model uses support, later writes check against it
+      node_cache_->probe(camera_->featureNames());
+      stageDone("capability probe");
 
       // Configure chunk data - Enable Metadata
       // SpinnakerCamera::ConfigureChunkData(*node_map_);
@@ -286,12 +575,12 @@ void SpinnakerCamera::disconnect()
     // Check if camera is connected
     if (pCam_)
     {
+      // No node handles may outlive DeInit, readers holding a copy keep theirs until they are done
+      setHandles(nullptr, nullptr, nullptr);
       pCam_->DeInit();
       pCam_ = static_cast<int>(NULL);
-      camList_.RemoveBySerial(std::to_string(serial_));
     }
-    Spinnaker::CameraList temp_list = system_->GetCameras();
-    camList_.Append(temp_list);
+    system_->refresh();
   }
   catch (const Spinnaker::Exception& e)
   {
@@ -310,6 +599,18 @@ void SpinnakerCamera::start()
       // Start capturing images
       pCam_->BeginAcquisition();
       captureRunning_ = true;
+
+      // The pixel format may have been reconfigured while stopped, look the encoding up again on the first frame.
+      encoding_valid_ = false;
+
+      if (restart_once_auto_modes_)
+      {
+        restart_once_auto_modes_ = false;
+        std::shared_ptr<Camera> camera;
+        getHandles(&camera, nullptr, nullptr);
+        if (camera)
+          camera->restartOnceAutoModes();
+      }
     }
   }
   catch (const Spinnaker::Exception& e)
@@ -335,7 +636,39 @@ void SpinnakerCamera::stop()
   }
 }
 
-void SpinnakerCamera::grabImage(sensor_msgs::Image* image, const std::string& frame_id)
+bool SpinnakerCamera::latchTimestamp(uint64_t* camera_stamp, ros::Time* host_before, ros::Time* host_after)
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  if (!pCam_ || !node_cache_)
+    return false;
+
+  // SFNC names first, older GigE cameras use the GigE Vision ones
+  Spinnaker::GenApi::CCommandPtr latch_ptr = node_cache_->getNode("TimestampLatch");
+  Spinnaker::GenApi::CIntegerPtr value_ptr = node_cache_->getNode("TimestampLatchValue");
+  if (!IsAvailable(latch_ptr) || !IsAvailable(value_ptr))
+  {
+    latch_ptr = node_cache_->getNode("GevTimestampControlLatch");
+    value_ptr = node_cache_->getNode("GevTimestampValue");
+  }
+  if (!IsWritable(latch_ptr) || !IsReadable(value_ptr))
+    return false;
+
+  try
+  {
+    *host_before = ros::Time::now();
+    latch_ptr->Execute();
+    *camera_stamp = static_cast<uint64_t>(value_ptr->GetValue());
+    *host_after = ros::Time::now();
+  }
+  catch (const Spinnaker::Exception& e)
+  {
+    throw std::runtime_error("[SpinnakerCamera::latchTimestamp] Failed to latch the timestamp: " +
+                             std::string(e.what()));
+  }
+  return true;
+}
+
+SpinnakerCamera::GrabResult SpinnakerCamera::grabImage(sensor_msgs::Image* image, const std::string& frame_id)
 {
   std::lock_guard<std::mutex> scopedLock(mutex_);
 
@@ -349,112 +682,52 @@ void SpinnakerCamera::grabImage(sensor_msgs::Image* image, const std::string& fr
       //  std::string format(image_ptr->GetPixelFormatName());
       //  std::printf("\033[100m format: %s \n", format.c_str());
 
+      // Set Image Time Stamp, this is the camera clock in nanoseconds, not ROS time,
+      image->header.stamp.fromNSec(image_ptr->GetTimeStamp());
+      // and the sequence number carries the camera's frame ID
+      image->header.seq = image_ptr->GetFrameID();
+      image->header.frame_id = frame_id;
+
       if (image_ptr->IsIncomplete())
       {
-        throw std::runtime_error("[SpinnakerCamera::grabImage] Image received from camera " + std::to_string(serial_) +
-                                 " is incomplete.");
+        // Usually a few lost packets, hand the buffer back and let the caller decide what to do about it
+        ROS_DEBUG_STREAM("[SpinnakerCamera::grabImage] Image " << image->header.seq << " received from camera "
+                                                               << serial_ << " is incomplete, status "
+                                                               << image_ptr->GetImageStatus() << ".");
+        image_ptr->Release();
+        return GRAB_INCOMPLETE;
       }
       else
       {
-        // Set Image Time Stamp
-        image->header.stamp.sec = image_ptr->GetTimeStamp() * 1e-9;
-        image->header.stamp.nsec = image_ptr->GetTimeStamp();
-
-        // Check the bits per pixel.
-        size_t bitsPerPixel = image_ptr->GetBitsPerPixel();
-
-        // --------------------------------------------------
-        // Set the image encoding
-        std::string imageEncoding = sensor_msgs::image_encodings::MONO8;
-
-        Spinnaker::GenApi::CEnumerationPtr color_filter_ptr =
-            static_cast<Spinnaker::GenApi::CEnumerationPtr>(node_map_->GetNode("PixelColorFilter"));
-
-        Spinnaker::GenICam::gcstring color_filter_str = color_filter_ptr->ToString();
-        Spinnaker::GenICam::gcstring bayer_rg_str = "BayerRG";
-        Spinnaker::GenICam::gcstring bayer_gr_str = "BayerGR";
-        Spinnaker::GenICam::gcstring bayer_gb_str = "BayerGB";
-        Spinnaker::GenICam::gcstring bayer_bg_str = "BayerBG";
-
-        // if(isColor_ && bayer_format != NONE)
-        if (color_filter_ptr->GetCurrentEntry() != color_filter_ptr->GetEntryByName("None"))
-        {
-          if (bitsPerPixel == 16)
-          {
-            // 16 Bits per Pixel
-            if (color_filter_str.compare(bayer_rg_str) == 0)
-            {
-              imageEncoding = sensor_msgs::image_encodings::BAYER_RGGB16;
-            }
-            else if (color_filter_str.compare(bayer_gr_str) == 0)
-            {
-              imageEncoding = sensor_msgs::image_encodings::BAYER_GRBG16;
-            }
-            else if (color_filter_str.compare(bayer_gb_str) == 0)
-            {
-              imageEncoding = sensor_msgs::image_encodings::BAYER_GBRG16;
-            }
-            else if (color_filter_str.compare(bayer_bg_str) == 0)
-            {
-              imageEncoding = sensor_msgs::image_encodings::BAYER_BGGR16;
-            }
-            else
-            {
-              throw std::runtime_error("[SpinnakerCamera::grabImage] Bayer format not recognized for 16-bit format.");
-            }
-          }
-          else
-          {
-            // 8 Bits per Pixel
-            if (color_filter_str.compare(bayer_rg_str) == 0)
-            {
-              imageEncoding = sensor_msgs::image_encodings::BAYER_RGGB8;
-            }
-            else if (color_filter_str.compare(bayer_gr_str) == 0)
-            {
-              imageEncoding = sensor_msgs::image_encodings::BAYER_GRBG8;
-            }
-            else if (color_filter_str.compare(bayer_gb_str) == 0)
-            {
-              imageEncoding = sensor_msgs::image_encodings::BAYER_GBRG8;
-            }
-            else if (color_filter_str.compare(bayer_bg_str) == 0)
-            {
-              imageEncoding = sensor_msgs::image_encodings::BAYER_BGGR8;
-            }
-            else
-            {
-              throw std::runtime_error("[SpinnakerCamera::grabImage] Bayer format not recognized for 8-bit format.");
-            }
-          }
-        }
-        else  // Mono camera or in pixel binned mode.
+        // Only resolve the encoding when the pixel format differs from the previous frame's, which in practice
+        // means once per stream.
+        const Spinnaker::PixelFormatEnums pixel_format = image_ptr->GetPixelFormat();
+        if (!encoding_valid_ || pixel_format != encoding_pixel_format_)
         {
-          if (bitsPerPixel == 16)
-          {
-            imageEncoding = sensor_msgs::image_encodings::MONO16;
-          }
-          else if (bitsPerPixel == 24)
-          {
-            imageEncoding = sensor_msgs::image_encodings::RGB8;
-          }
-          else
-          {
-            imageEncoding = sensor_msgs::image_encodings::MONO8;
-          }
+          encoding_ = resolveEncoding(pixel_format, image_ptr->GetBitsPerPixel());
+          encoding_pixel_format_ = pixel_format;
+          encoding_valid_ = true;
         }
 
-        int width = image_ptr->GetWidth();
-        int height = image_ptr->GetHeight();
-        int stride = image_ptr->GetStride();
-
-        // ROS_INFO_ONCE("\033[93m wxh: (%d, %d), stride: %d \n", width, height, stride);
-        fillImage(*image, imageEncoding, height, width, stride, image_ptr->GetData());
-        image->header.frame_id = frame_id;
+        // Copy the payload straight out of the stream buffer. Unlike fillImage this does not zero the vector
+        // before overwriting it, and it reuses the existing allocation when the message is recycled.
+        const uint8_t* data = static_cast<const uint8_t*>(image_ptr->GetData());
+        image->encoding = encoding_;
+        image->height = image_ptr->GetHeight();
+        image->width = image_ptr->GetWidth();
+        image->step = image_ptr->GetStride();
+        image->is_bigendian = 0;
+        image->data.assign(data, data + static_cast<size_t>(image->step) * image->height);
+
+        // Hand the buffer back to the stream as soon as the payload has been copied.
+        image_ptr->Release();
       }  // end else
     }
     catch (const Spinnaker::Exception& e)
     {
+      // The SDK reports a timeout as an exception, it is only a fault if the caller decides so
+      if (e.GetError() == Spinnaker::SPINNAKER_ERR_TIMEOUT)
+        return GRAB_TIMEOUT;
       throw std::runtime_error("[SpinnakerCamera::grabImage] Failed to retrieve buffer with error: " +
                                std::string(e.what()));
     }
@@ -468,10 +741,150 @@ void SpinnakerCamera::grabImage(sensor_msgs::Image* image, const std::string& fr
   {
     throw std::runtime_error("[SpinnakerCamera::grabImage] Not connected to the camera.");
   }
+  return GRAB_OK;
 }  // end grabImage
 
+std::string SpinnakerCamera::resolveEncoding(const Spinnaker::PixelFormatEnums pixel_format,
+                                             const size_t bitsPerPixel)
+{
+  // Pixel formats that map one to one onto a sensor_msgs encoding.
+  typedef std::pair<Spinnaker::PixelFormatEnums, std::string> FormatEncoding;
+  static const std::vector<FormatEncoding> format_encodings
+  {
+    FormatEncoding(Spinnaker::PixelFormat_Mono8, sensor_msgs::image_encodings::MONO8),
+    FormatEncoding(Spinnaker::PixelFormat_Mono16, sensor_msgs::image_encodings::MONO16),
+    FormatEncoding(Spinnaker::PixelFormat_RGB8, sensor_msgs::image_encodings::RGB8),
+    FormatEncoding(Spinnaker::PixelFormat_RGB8Packed, sensor_msgs::image_encodings::RGB8),
+    FormatEncoding(Spinnaker::PixelFormat_BGR8, sensor_msgs::image_encodings::BGR8),
+    FormatEncoding(Spinnaker::PixelFormat_BGRa8, sensor_msgs::image_encodings::BGRA8),
+    FormatEncoding(Spinnaker::PixelFormat_BayerRG8, sensor_msgs::image_encodings::BAYER_RGGB8),
+    FormatEncoding(Spinnaker::PixelFormat_BayerGR8, sensor_msgs::image_encodings::BAYER_GRBG8),
+    FormatEncoding(Spinnaker::PixelFormat_BayerGB8, sensor_msgs::image_encodings::BAYER_GBRG8),
+    FormatEncoding(Spinnaker::PixelFormat_BayerBG8, sensor_msgs::image_encodings::BAYER_BGGR8),
+    FormatEncoding(Spinnaker::PixelFormat_BayerRG16, sensor_msgs::image_encodings::BAYER_RGGB16),
+    FormatEncoding(Spinnaker::PixelFormat_BayerGR16, sensor_msgs::image_encodings::BAYER_GRBG16),
+    FormatEncoding(Spinnaker::PixelFormat_BayerGB16, sensor_msgs::image_encodings::BAYER_GBRG16),
+    FormatEncoding(Spinnaker::PixelFormat_BayerBG16, sensor_msgs::image_encodings::BAYER_BGGR16)
+  };
+
+  for (const FormatEncoding& format_encoding : format_encodings)
+  {
+    if (format_encoding.first == pixel_format)
+      return format_encoding.second;
+  }
+
+  // Anything else (packed and YUV formats) is classified by the color filter and the bits per pixel.
+  std::string imageEncoding = sensor_msgs::image_encodings::MONO8;
+
+  Spinnaker::GenApi::CEnumerationPtr color_filter_ptr =
+      static_cast<Spinnaker::GenApi::CEnumerationPtr>(node_cache_->getNode("PixelColorFilter"));
+
+  Spinnaker::GenICam::gcstring color_filter_str = color_filter_ptr->ToString();
+  Spinnaker::GenICam::gcstring bayer_rg_str = "BayerRG";
+  Spinnaker::GenICam::gcstring bayer_gr_str = "BayerGR";
+  Spinnaker::GenICam::gcstring bayer_gb_str = "BayerGB";
+  Spinnaker::GenICam::gcstring bayer_bg_str = "BayerBG";
+
+  // if(isColor_ && bayer_format != NONE)
+  if (color_filter_ptr->GetCurrentEntry() != color_filter_ptr->GetEntryByName("None"))
+  {
+    if (bitsPerPixel == 16)
+    {
+      // 16 Bits per Pixel
+      if (color_filter_str.compare(bayer_rg_str) == 0)
+      {
+        imageEncoding = sensor_msgs::image_encodings::BAYER_RGGB16;
+      }
+      else if (color_filter_str.compare(bayer_gr_str) == 0)
+      {
+        imageEncoding = sensor_msgs::image_encodings::BAYER_GRBG16;
+      }
+      else if (color_filter_str.compare(bayer_gb_str) == 0)
+      {
+        imageEncoding = sensor_msgs::image_encodings::BAYER_GBRG16;
+      }
+      else if (color_filter_str.compare(bayer_bg_str) == 0)
+      {
+        imageEncoding = sensor_msgs::image_encodings::BAYER_BGGR16;
+      }
+      else
+      {
+        throw std::runtime_error("[SpinnakerCamera::resolveEncoding] Bayer format not recognized for 16-bit format.");
+      }
+    }
+    else
+    {
+      // 8 Bits per Pixel
+      if (color_filter_str.compare(bayer_rg_str) == 0)
+      {
+        imageEncoding = sensor_msgs::image_encodings::BAYER_RGGB8;
+      }
+      else if (color_filter_str.compare(bayer_gr_str) == 0)
+      {
+        imageEncoding = sensor_msgs::image_encodings::BAYER_GRBG8;
+      }
+      else if (color_filter_str.compare(bayer_gb_str) == 0)
+      {
+        imageEncoding = sensor_msgs::image_encodings::BAYER_GBRG8;
+      }
+      else if (color_filter_str.compare(bayer_bg_str) == 0)
+      {
+        imageEncoding = sensor_msgs::image_encodings::BAYER_BGGR8;
+      }
+      else
+      {
+        throw std::runtime_error("[SpinnakerCamera::resolveEncoding] Bayer format not recognized for 8-bit format.");
+      }
+    }
+  }
+  else  // Mono camera or in pixel binned mode.
+  {
+    if (bitsPerPixel == 16)
+    {
+      imageEncoding = sensor_msgs::image_encodings::MONO16;
+    }
+    else if (bitsPerPixel == 24)
+    {
+      imageEncoding = sensor_msgs::image_encodings::RGB8;
+    }
+    else
+    {
+      imageEncoding = sensor_msgs::image_encodings::MONO8;
+    }
+  }
+
+  return imageEncoding;
+}
+
 void SpinnakerCamera::setTimeout(const double& timeout)
 {
+  fixed_timeout_ = std::max(timeout, 0.0);
+  if (fixed_timeout_ > 0.0)
+    timeout_ = static_cast<uint64_t>(std::round(fixed_timeout_ * 1000));
+}
+
+void SpinnakerCamera::updateTimeout(const spinnaker_camera_driver::SpinnakerConfig& config)
+{
+  trigger_enabled_ = config.enable_trigger == "On";
+  if (fixed_timeout_ > 0.0)
+    return;
+
+  double timeout = 0.5;  // Between triggers, only long enough not to spin
+  if (!trigger_enabled_)
+  {
+    // Prefer the rate the camera settled on over the requested one
+    double frame_rate = 0.0;
+    Spinnaker::GenApi::CFloatPtr frame_rate_ptr = node_cache_->getNode("AcquisitionResultingFrameRate");
+    if (IsAvailable(frame_rate_ptr) && IsReadable(frame_rate_ptr))
+      frame_rate = frame_rate_ptr->GetValue();
+    else if (config.acquisition_frame_rate_enable)
+      frame_rate = config.acquisition_frame_rate;
+
+    const double frame_period = frame_rate > 0.0 ? 1.0 / frame_rate : 1.0;
+    const double exposure =
+        1e-6 * (config.exposure_auto == "Off" ? config.exposure_time : config.auto_exposure_time_upper_limit);
+    timeout = std::min(std::max(3.0 * frame_period + exposure, 0.1), 10.0);
+  }
   timeout_ = static_cast<uint64_t>(std::round(timeout * 1000));
 }
 void SpinnakerCamera::setDesiredCamera(const uint32_t& id)
@@ -24,230 +24,657 @@ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSI
 */
 #include "spinnaker_camera_driver/camera.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace spinnaker_camera_driver
 {
-void Camera::init()
+namespace
 {
-  Spinnaker::GenApi::CIntegerPtr height_max_ptr = node_map_->GetNode("HeightMax");
-  if (!IsAvailable(height_max_ptr) || !IsReadable(height_max_ptr))
-  {
-    throw std::runtime_error("[Camera::init] Unable to read HeightMax");
-  }
-  height_max_ = height_max_ptr->GetValue();
-  roi_height_ = height_max_;
-  roi_y_offset_ = 0;
-  Spinnaker::GenApi::CIntegerPtr width_max_ptr = node_map_->GetNode("WidthMax");
-  if (!IsAvailable(width_max_ptr) || !IsReadable(width_max_ptr))
-  {
-    throw std::runtime_error("[Camera::init] Unable to read WidthMax");
-  }
-  width_max_ = width_max_ptr->GetValue();
-  roi_width_ = width_max_;
-  roi_x_offset_ = 0;
-  // Set Throughput to maximum
-  //=====================================
-  setMaxInt(node_map_, "DeviceLinkThroughputLimit");
+constexpr FeatureNodes onAllModels(const char* name)
+{
+  return FeatureNodes{ { name, name } };
 }
-void Camera::setFrameRate(const float frame_rate)
+
+constexpr FeatureNodes byModel(const char* blackfly_s, const char* chameleon3)
 {
-  // This enables the "AcquisitionFrameRateEnabled"
-  //======================================
-  setProperty(node_map_, "AcquisitionFrameRateEnable", true);
+  return FeatureNodes{ { blackfly_s, chameleon3 } };
+}
 
-  // This sets the "AcquisitionFrameRate" to X FPS
-  // ========================================
+typedef bool (*FeatureCondition)(const SpinnakerConfig& config);
 
-  Spinnaker::GenApi::CFloatPtr ptrAcquisitionFrameRate = node_map_->GetNode("AcquisitionFrameRate");
-  ROS_DEBUG_STREAM("Minimum Frame Rate: \t " << ptrAcquisitionFrameRate->GetMin());
-  ROS_DEBUG_STREAM("Maximum Frame rate: \t " << ptrAcquisitionFrameRate->GetMax());
+constexpr FeatureDescriptor floatFeature(FeatureNodes nodes, bool ConfigChanges::*group,
+                                         double SpinnakerConfig::*field, FeatureCondition condition = nullptr,
+                                         bool optional = false)
+{
+  return FeatureDescriptor{ nodes, FeatureDescriptor::TYPE_FLOAT, group, condition, optional, false,
+                            field, nullptr, nullptr, nullptr, nullptr };
+}
 
-  // Finally Set the Frame Rate
-  setProperty(node_map_, "AcquisitionFrameRate", frame_rate);
+constexpr FeatureDescriptor intFeature(FeatureNodes nodes, bool ConfigChanges::*group, int SpinnakerConfig::*field)
+{
+  return FeatureDescriptor{ nodes, FeatureDescriptor::TYPE_INT, group, nullptr, false, false,
+                            nullptr, field, nullptr, nullptr, nullptr };
+}
 
-  ROS_DEBUG_STREAM("Current Frame rate: \t " << ptrAcquisitionFrameRate->GetValue());
+constexpr FeatureDescriptor boolFeature(FeatureNodes nodes, bool ConfigChanges::*group, bool SpinnakerConfig::*field,
+                                        FeatureCondition condition = nullptr, bool optional = false)
+{
+  return FeatureDescriptor{ nodes, FeatureDescriptor::TYPE_BOOL, group, condition, optional, false,
+                            nullptr, nullptr, field, nullptr, nullptr };
 }
 
-void Camera::setNewConfiguration(const SpinnakerConfig& config, const uint32_t& level)
+constexpr FeatureDescriptor enumFeature(FeatureNodes nodes, bool ConfigChanges::*group,
+                                        std::string SpinnakerConfig::*field, bool optional = false)
 {
-  try
+  return FeatureDescriptor{ nodes, FeatureDescriptor::TYPE_ENUM, group, nullptr, optional, false,
+                            nullptr, nullptr, nullptr, field, nullptr };
+}
+
+constexpr FeatureDescriptor entryFeature(FeatureNodes nodes, bool ConfigChanges::*group, const char* entry,
+                                         FeatureCondition condition = nullptr, bool optional = false)
+{
+  return FeatureDescriptor{ nodes, FeatureDescriptor::TYPE_ENTRY, group, condition, optional, false,
+                            nullptr, nullptr, nullptr, nullptr, entry };
+}
+
+constexpr FeatureDescriptor enableFeature(FeatureNodes nodes, bool ConfigChanges::*group)
+{
+  return FeatureDescriptor{ nodes, FeatureDescriptor::TYPE_ENABLE, group, nullptr, false, false,
+                            nullptr, nullptr, nullptr, nullptr, nullptr };
+}
+
+/// Marks a feature the camera only takes while acquisition is stopped.
+constexpr FeatureDescriptor lockedWhileStreaming(FeatureDescriptor feature)
+{
+  return FeatureDescriptor{ feature.nodes, feature.type, feature.group, feature.condition, feature.optional, true,
+                            feature.float_field, feature.int_field, feature.bool_field, feature.enum_field,
+                            feature.entry };
+}
+
+bool exposureAutoOff(const SpinnakerConfig& config)
+{
+  return config.exposure_auto == "Off";
+}
+
+bool exposureAutoOn(const SpinnakerConfig& config)
+{
+  return config.exposure_auto != "Off";
+}
+
+bool gainAutoOff(const SpinnakerConfig& config)
+{
+  return config.auto_gain == "Off";
+}
+
+bool sharpeningEnabled(const SpinnakerConfig& config)
+{
+  return config.sharpening_enable;
+}
+
+bool saturationEnabled(const SpinnakerConfig& config)
+{
+  return config.saturation_enable;
+}
+
+bool gammaEnabled(const SpinnakerConfig& config)
+{
+  return config.gamma_enable;
+}
+
+bool whiteBalanceAutoOff(const SpinnakerConfig& config)
+{
+  return config.auto_white_balance == "Off";
+}
+
+// Binning and decimation, written before the maximum image size is read back. The Chameleon3 only bins vertically.
+constexpr FeatureDescriptor IMAGE_FORMAT_FEATURES[] = {
+  lockedWhileStreaming(intFeature(byModel("BinningHorizontal", nullptr), &ConfigChanges::image_format,
+                                  &SpinnakerConfig::image_format_x_binning)),
+  lockedWhileStreaming(intFeature(onAllModels("BinningVertical"), &ConfigChanges::image_format,
+                                  &SpinnakerConfig::image_format_y_binning)),
+  lockedWhileStreaming(intFeature(byModel("DecimationHorizontal", nullptr), &ConfigChanges::image_format,
+                                  &SpinnakerConfig::image_format_x_decimation)),
+  lockedWhileStreaming(intFeature(byModel("DecimationVertical", nullptr), &ConfigChanges::image_format,
+                                  &SpinnakerConfig::image_format_y_decimation)),
+};
+
+// Everything else, in the order it is written
+constexpr FeatureDescriptor FEATURES[] = {
+  // The frame rate is enabled while it is set, then the configured enable is applied in case it is false
+  enableFeature(byModel("AcquisitionFrameRateEnable", "AcquisitionFrameRateEnabled"), &ConfigChanges::frame_rate),
+  entryFeature(byModel(nullptr, "AcquisitionFrameRateAuto"), &ConfigChanges::frame_rate, "Off"),
+  floatFeature(onAllModels("AcquisitionFrameRate"), &ConfigChanges::frame_rate,
+               &SpinnakerConfig::acquisition_frame_rate),
+  boolFeature(byModel("AcquisitionFrameRateEnable", "AcquisitionFrameRateEnabled"), &ConfigChanges::frame_rate,
+              &SpinnakerConfig::acquisition_frame_rate_enable),
+
+  // The trigger must be off while the source is changed. Only do so when that is what changed, turning it off
+  // interrupts triggered capture.
+  enumFeature(onAllModels("TriggerSelector"), &ConfigChanges::trigger_setup, &SpinnakerConfig::trigger_selector),
+  entryFeature(onAllModels("TriggerMode"), &ConfigChanges::trigger_setup, "Off"),
+  enumFeature(onAllModels("TriggerSource"), &ConfigChanges::trigger_setup, &SpinnakerConfig::trigger_source),
+  enumFeature(onAllModels("TriggerActivation"), &ConfigChanges::trigger_setup,
+              &SpinnakerConfig::trigger_activation_mode),
+  enumFeature(onAllModels("TriggerMode"), &ConfigChanges::trigger_mode, &SpinnakerConfig::enable_trigger),
+
+  enumFeature(onAllModels("LineSelector"), &ConfigChanges::lines, &SpinnakerConfig::line_selector),
+  enumFeature(onAllModels("LineMode"), &ConfigChanges::lines, &SpinnakerConfig::line_mode),
+  enumFeature(byModel("LineSource", nullptr), &ConfigChanges::lines, &SpinnakerConfig::line_source),
+
+  lockedWhileStreaming(
+      enumFeature(onAllModels("ExposureMode"), &ConfigChanges::exposure, &SpinnakerConfig::exposure_mode)),
+  enumFeature(onAllModels("ExposureAuto"), &ConfigChanges::exposure, &SpinnakerConfig::exposure_auto),
+
+  boolFeature(onAllModels("SharpeningEnable"), &ConfigChanges::sharpening, &SpinnakerConfig::sharpening_enable,
+              nullptr, true),
+  boolFeature(onAllModels("SharpeningAuto"), &ConfigChanges::sharpening, &SpinnakerConfig::auto_sharpness,
+              sharpeningEnabled, true),
+  floatFeature(onAllModels("Sharpening"), &ConfigChanges::sharpening, &SpinnakerConfig::sharpness, sharpeningEnabled,
+               true),
+  floatFeature(onAllModels("SharpeningThreshold"), &ConfigChanges::sharpening, &SpinnakerConfig::sharpening_threshold,
+               sharpeningEnabled, true),
+
+  boolFeature(onAllModels("SaturationEnable"), &ConfigChanges::saturation, &SpinnakerConfig::saturation_enable,
+              nullptr, true),
+  floatFeature(onAllModels("Saturation"), &ConfigChanges::saturation, &SpinnakerConfig::saturation,
+               saturationEnabled, true),
+
+  floatFeature(onAllModels("ExposureTime"), &ConfigChanges::exposure, &SpinnakerConfig::exposure_time,
+               exposureAutoOff),
+  floatFeature(byModel("AutoExposureExposureTimeUpperLimit", "AutoExposureTimeUpperLimit"), &ConfigChanges::exposure,
+               &SpinnakerConfig::auto_exposure_time_upper_limit, exposureAutoOn),
+
+  // GainSelector is not writable on the Chameleon3
+  enumFeature(byModel("GainSelector", nullptr), &ConfigChanges::gain, &SpinnakerConfig::gain_selector),
+  enumFeature(onAllModels("GainAuto"), &ConfigChanges::gain, &SpinnakerConfig::auto_gain),
+  floatFeature(onAllModels("Gain"), &ConfigChanges::gain, &SpinnakerConfig::gain, gainAutoOff),
+
+  floatFeature(onAllModels("BlackLevel"), &ConfigChanges::black_level, &SpinnakerConfig::brightness),
+
+  boolFeature(byModel("GammaEnable", "GammaEnabled"), &ConfigChanges::gamma, &SpinnakerConfig::gamma_enable,
+              gammaEnabled),
+  floatFeature(onAllModels("Gamma"), &ConfigChanges::gamma, &SpinnakerConfig::gamma, gammaEnabled),
+
+  enumFeature(onAllModels("BalanceWhiteAuto"), &ConfigChanges::white_balance, &SpinnakerConfig::auto_white_balance,
+              true),
+  entryFeature(onAllModels("BalanceRatioSelector"), &ConfigChanges::white_balance, "Blue", whiteBalanceAutoOff, true),
+  floatFeature(onAllModels("BalanceRatio"), &ConfigChanges::white_balance, &SpinnakerConfig::white_balance_blue_ratio,
+               whiteBalanceAutoOff, true),
+  entryFeature(onAllModels("BalanceRatioSelector"), &ConfigChanges::white_balance, "Red", whiteBalanceAutoOff, true),
+  floatFeature(onAllModels("BalanceRatio"), &ConfigChanges::white_balance, &SpinnakerConfig::white_balance_red_ratio,
+               whiteBalanceAutoOff, true),
+
+  lockedWhileStreaming(boolFeature(byModel("ReverseX", nullptr), &ConfigChanges::reverse, &SpinnakerConfig::reverse_x)),
+  lockedWhileStreaming(boolFeature(byModel("ReverseY", nullptr), &ConfigChanges::reverse, &SpinnakerConfig::reverse_y)),
+};
+
+/// Sets the field a feature writes to its value in from. Features that write a fixed value have no field.
+void copyField(const FeatureDescriptor& feature, const SpinnakerConfig& from, SpinnakerConfig* to)
+{
+  switch (feature.type)
   {
-    if (level >= LEVEL_RECONFIGURE_STOP)
-      setImageControlFormats(config);
-
-    setFrameRate(static_cast<float>(config.acquisition_frame_rate));
-    // Set enable after frame rate encase its false
-    setProperty(node_map_, "AcquisitionFrameRateEnable", config.acquisition_frame_rate_enable);
-
-    // Set Trigger and Strobe Settings
-    // NOTE: The trigger must be disabled (i.e. TriggerMode = "Off") in order to configure whether the source is
-    // software or hardware.
-    setProperty(node_map_, "TriggerMode", std::string("Off"));
-    setProperty(node_map_, "TriggerSource", config.trigger_source);
-    setProperty(node_map_, "TriggerSelector", config.trigger_selector);
-    setProperty(node_map_, "TriggerActivation", config.trigger_activation_mode);
-    setProperty(node_map_, "TriggerMode", config.enable_trigger);
-
-    setProperty(node_map_, "LineSelector", config.line_selector);
-    setProperty(node_map_, "LineMode", config.line_mode);
-    setProperty(node_map_, "LineSource", config.line_source);
-
-    // Set auto exposure
-    setProperty(node_map_, "ExposureMode", config.exposure_mode);
-    setProperty(node_map_, "ExposureAuto", config.exposure_auto);
-
-    // Set sharpness
-    if (IsAvailable(node_map_->GetNode("SharpeningEnable")))
-    {
-      setProperty(node_map_, "SharpeningEnable", config.sharpening_enable);
-      if (config.sharpening_enable)
-      {
-        setProperty(node_map_, "SharpeningAuto", config.auto_sharpness);
-        setProperty(node_map_, "Sharpening", static_cast<float>(config.sharpness));
-        setProperty(node_map_, "SharpeningThreshold", static_cast<float>(config.sharpening_threshold));
-      }
-    }
+    case FeatureDescriptor::TYPE_FLOAT:
+      to->*feature.float_field = from.*feature.float_field;
+      break;
+    case FeatureDescriptor::TYPE_INT:
+      to->*feature.int_field = from.*feature.int_field;
+      break;
+    case FeatureDescriptor::TYPE_BOOL:
+      to->*feature.bool_field = from.*feature.bool_field;
+      break;
+    case FeatureDescriptor::TYPE_ENUM:
+      to->*feature.enum_field = from.*feature.enum_field;
+      break;
+    case FeatureDescriptor::TYPE_ENTRY:
+    case FeatureDescriptor::TYPE_ENABLE:
+      break;
+  }
+}
 
-    // Set saturation
-    if (IsAvailable(node_map_->GetNode("SaturationEnable")))
+/*!
+* \brief Writes the features of a table that changed and that the model has.
+*
+* \param skipped Gets the groups of features set that the camera has but that could not be written, e.g. because they
+*                were not writable at the moment.
+* \param recorded The fields of those features are set back to their values in last, so that they are not taken for
+*                 applied.
+*/
+template <size_t N>
+void applyFeatures(const FeatureDescriptor (&features)[N], const CameraModel model, NodeCache* node_map,
+                   ConfigTransaction* transaction, const SpinnakerConfig& config, const ConfigChanges& changes,
+                   const SpinnakerConfig& last, ConfigChanges* skipped, SpinnakerConfig* recorded)
+{
+  for (const FeatureDescriptor& feature : features)
+  {
+    const char* node_name = feature.nodes.names[model];
+    if (!node_name || !(changes.*feature.group) || (feature.condition && !feature.condition(config)))
+      continue;
+    if (feature.optional && !node_map->isAvailable(node_name))
+      continue;
+
+    bool written = false;
+    switch (feature.type)
     {
-      setProperty(node_map_, "SaturationEnable", config.saturation_enable);
-      if (config.saturation_enable)
-      {
-        setProperty(node_map_, "Saturation", static_cast<float>(config.saturation));
-      }
+      case FeatureDescriptor::TYPE_FLOAT:
+        written = transaction->set(node_name, static_cast<float>(config.*feature.float_field));
+        break;
+      case FeatureDescriptor::TYPE_INT:
+        written = transaction->set(node_name, config.*feature.int_field);
+        break;
+      case FeatureDescriptor::TYPE_BOOL:
+        written = transaction->set(node_name, config.*feature.bool_field);
+        break;
+      case FeatureDescriptor::TYPE_ENUM:
+        written = transaction->set(node_name, config.*feature.enum_field);
+        break;
+      case FeatureDescriptor::TYPE_ENTRY:
+        written = transaction->set(node_name, feature.entry);
+        break;
+      case FeatureDescriptor::TYPE_ENABLE:
+        written = transaction->set(node_name, true);
+        break;
     }
 
-    // Set shutter time/speed
-    if (config.exposure_auto.compare(std::string("Off")) == 0)
-    {
-      setProperty(node_map_, "ExposureTime", static_cast<float>(config.exposure_time));
-    }
-    else
+    // A feature the camera lacks will never be written, retrying it would only repeat the warning
+    if (!written && node_map->isImplemented(node_name))
     {
-      setProperty(node_map_, "AutoExposureExposureTimeUpperLimit",
-                  static_cast<float>(config.auto_exposure_time_upper_limit));
+      skipped->*feature.group = true;
+      copyField(feature, last, recorded);
     }
+  }
+}
+
+/// Whether a locked feature the model has would be written with a different value than last applied.
+template <size_t N>
+bool lockedFeatureChanged(const FeatureDescriptor (&features)[N], const CameraModel model,
+                          const SpinnakerConfig& config, const SpinnakerConfig& last, const ConfigChanges& changes)
+{
+  for (const FeatureDescriptor& feature : features)
+  {
+    if (!feature.locked || !feature.nodes.names[model] || !(changes.*feature.group))
+      continue;
 
-    // Set gain
-    setProperty(node_map_, "GainSelector", config.gain_selector);
-    setProperty(node_map_, "GainAuto", config.auto_gain);
-    if (config.auto_gain.compare(std::string("Off")) == 0)
+    switch (feature.type)
     {
-      setProperty(node_map_, "Gain", static_cast<float>(config.gain));
+      case FeatureDescriptor::TYPE_FLOAT:
+        if (config.*feature.float_field != last.*feature.float_field)
+          return true;
+        break;
+      case FeatureDescriptor::TYPE_INT:
+        if (config.*feature.int_field != last.*feature.int_field)
+          return true;
+        break;
+      case FeatureDescriptor::TYPE_BOOL:
+        if (config.*feature.bool_field != last.*feature.bool_field)
+          return true;
+        break;
+      case FeatureDescriptor::TYPE_ENUM:
+        if (config.*feature.enum_field != last.*feature.enum_field)
+          return true;
+        break;
+      case FeatureDescriptor::TYPE_ENTRY:
+      case FeatureDescriptor::TYPE_ENABLE:
+        // Written whenever the group changed
+        return true;
     }
+  }
+  return false;
+}
 
-    // Set brightness
-    setProperty(node_map_, "BlackLevel", static_cast<float>(config.brightness));
+/// Adds the node names a table uses on the model, skipping ones already listed.
+template <size_t N>
+void addFeatureNames(const FeatureDescriptor (&features)[N], const CameraModel model, std::vector<std::string>* names)
+{
+  for (const FeatureDescriptor& feature : features)
+  {
+    const char* node_name = feature.nodes.names[model];
+    if (node_name && std::find(names->begin(), names->end(), node_name) == names->end())
+      names->push_back(node_name);
+  }
+}
+}  // namespace
 
-    // Set gamma
-    if (config.gamma_enable)
-    {
-      setProperty(node_map_, "GammaEnable", config.gamma_enable);
-      setProperty(node_map_, "Gamma", static_cast<float>(config.gamma));
-    }
+void Camera::init()
+{
+  int64_t height_max;
+  if (!node_map_->readInteger("HeightMax", &height_max))
+  {
+    throw std::runtime_error("[Camera::init] Unable to read HeightMax");
+  }
+  height_max_ = height_max;
+  int64_t width_max;
+  if (!node_map_->readInteger("WidthMax", &width_max))
+  {
+    throw std::runtime_error("[Camera::init] Unable to read WidthMax");
+  }
+  width_max_ = width_max;
+  // The camera keeps the ROI of its last user
+  readROI();
+  // Set Throughput to maximum
+  //=====================================
+  ConfigTransaction transaction(node_map_);
+  transaction.setMax("DeviceLinkThroughputLimit");
+  transaction.commit();
+}
+void Camera::setNewConfiguration(const SpinnakerConfig& config, const uint32_t& level)
+{
+  const ConfigChanges changes = diffConfiguration(config);
+  const bool write_image_format = level >= LEVEL_RECONFIGURE_STOP && changes.image_format;
 
-    // Set white balance
-    if (IsAvailable(node_map_->GetNode("BalanceWhiteAuto")))
-    {
-      setProperty(node_map_, "BalanceWhiteAuto", config.auto_white_balance);
-      if (config.auto_white_balance.compare(std::string("Off")) == 0)
-      {
-        setProperty(node_map_, "BalanceRatioSelector", "Blue");
-        setProperty(node_map_, "BalanceRatio", static_cast<float>(config.white_balance_blue_ratio));
-        setProperty(node_map_, "BalanceRatioSelector", "Red");
-        setProperty(node_map_, "BalanceRatio", static_cast<float>(config.white_balance_red_ratio));
-      }
-    }
+  // What ends up recorded as applied, without the features that were not written
+  SpinnakerConfig recorded = config;
+  ConfigChanges skipped = ConfigChanges();
+  if (changes.image_format && !write_image_format)
+  {
+    keepImageFormat(&recorded);
+    skipped.image_format = true;
+  }
+  try
+  {
+    // Undone when an exception leaves this scope before the commit
+    ConfigTransaction transaction(node_map_);
 
-    setProperty(node_map_, "ReverseX", config.reverse_x);
-    setProperty(node_map_, "ReverseY", config.reverse_y);
+    if (write_image_format)
+      setImageControlFormats(&transaction, config, &skipped, &recorded);
+    applyFeatures(FEATURES, model_, node_map_, &transaction, config, changes, applied_config_, &skipped, &recorded);
+    transaction.commit();
   }
   catch (const Spinnaker::Exception& e)
   {
+    configurationApplied(config, false);
     throw std::runtime_error("[Camera::setNewConfiguration] Failed to set configuration: " + std::string(e.what()));
   }
+  configurationApplied(recorded, true);
+  unapplied_ = skipped;
+
+  // The camera clamps the exposure to what the frame rate allows, keep what it took so that the next diff sees it
+  if (changes.exposure && exposureAutoOff(config))
+    readWritten("ExposureTime", &applied_config_.exposure_time);
+}
+
+void Camera::readWritten(const Spinnaker::GenICam::gcstring& property_name, double* value)
+{
+  node_map_->readFloat(property_name, value);
+}
+
+ConfigChanges Camera::diffConfiguration(const SpinnakerConfig& config) const
+{
+  const bool all = !config_applied_;
+  const SpinnakerConfig& last = applied_config_;
+  // Groups the last configuration left partly unwritten count as changed until they are written
+  const ConfigChanges& again = unapplied_;
+
+  ConfigChanges changes;
+  changes.image_format = all || again.image_format ||
+                         config.image_format_x_binning != last.image_format_x_binning ||
+                         config.image_format_y_binning != last.image_format_y_binning ||
+                         config.image_format_x_decimation != last.image_format_x_decimation ||
+                         config.image_format_y_decimation != last.image_format_y_decimation ||
+                         clampROIWidth(config.image_format_roi_width) != clampROIWidth(last.image_format_roi_width) ||
+                         clampROIHeight(config.image_format_roi_height) !=
+                             clampROIHeight(last.image_format_roi_height) ||
+                         config.image_format_x_offset != last.image_format_x_offset ||
+                         config.image_format_y_offset != last.image_format_y_offset ||
+                         config.image_format_color_coding != last.image_format_color_coding;
+  // The frame rate limits follow the image format
+  changes.frame_rate = changes.image_format || again.frame_rate ||
+                       config.acquisition_frame_rate != last.acquisition_frame_rate ||
+                       config.acquisition_frame_rate_enable != last.acquisition_frame_rate_enable;
+  changes.trigger_setup = all || again.trigger_setup || config.trigger_selector != last.trigger_selector ||
+                          config.trigger_source != last.trigger_source ||
+                          config.trigger_activation_mode != last.trigger_activation_mode;
+  // Changing the trigger setup turns the trigger off, so it has to be set again afterwards
+  changes.trigger_mode = changes.trigger_setup || again.trigger_mode || config.enable_trigger != last.enable_trigger;
+  changes.lines = all || again.lines || config.line_selector != last.line_selector ||
+                  config.line_mode != last.line_mode || config.line_source != last.line_source;
+  // The maximum exposure time follows the frame rate, so an exposure clamped before may fit now
+  changes.exposure = all || again.exposure || changes.frame_rate || config.exposure_mode != last.exposure_mode ||
+                     config.exposure_auto != last.exposure_auto || config.exposure_time != last.exposure_time ||
+                     config.auto_exposure_time_upper_limit != last.auto_exposure_time_upper_limit;
+  changes.sharpening = all || again.sharpening || config.sharpening_enable != last.sharpening_enable ||
+                       config.auto_sharpness != last.auto_sharpness || config.sharpness != last.sharpness ||
+                       config.sharpening_threshold != last.sharpening_threshold;
+  changes.saturation = all || again.saturation || config.saturation_enable != last.saturation_enable ||
+                       config.saturation != last.saturation;
+  changes.gain = all || again.gain || config.gain_selector != last.gain_selector ||
+                 config.auto_gain != last.auto_gain || config.gain != last.gain;
+  changes.black_level = all || again.black_level || config.brightness != last.brightness;
+  changes.gamma = all || again.gamma || config.gamma_enable != last.gamma_enable || config.gamma != last.gamma;
+  changes.white_balance = all || again.white_balance || config.auto_white_balance != last.auto_white_balance ||
+                          config.white_balance_blue_ratio != last.white_balance_blue_ratio ||
+                          config.white_balance_red_ratio != last.white_balance_red_ratio;
+  changes.reverse = all || again.reverse || config.reverse_x != last.reverse_x || config.reverse_y != last.reverse_y;
+  return changes;
+}
+
+bool Camera::needsAcquisitionStop(const SpinnakerConfig& config) const
+{
+  // The ROI and pixel format are not in the tables, they are written along with the image format group
+  const ConfigChanges changes = diffConfiguration(config);
+  return !config_applied_ || changes.image_format ||
+         lockedFeatureChanged(IMAGE_FORMAT_FEATURES, model_, config, applied_config_, changes) ||
+         lockedFeatureChanged(FEATURES, model_, config, applied_config_, changes);
+}
+
+void Camera::configurationLoaded(const SpinnakerConfig& config)
+{
+  int64_t height_max;
+  int64_t width_max;
+  if (!node_map_->readInteger("HeightMax", &height_max) || !node_map_->readInteger("WidthMax", &width_max))
+  {
+    throw std::runtime_error("[Camera::configurationLoaded] Unable to read the image size");
+  }
+  height_max_ = height_max;
+  width_max_ = width_max;
+  readROI();
+
+  configurationApplied(config, true);
+}
+
+void Camera::readROI()
+{
+  int64_t width;
+  int64_t height;
+  int64_t offset_x;
+  int64_t offset_y;
+  if (!node_map_->readInteger("Width", &width) || !node_map_->readInteger("Height", &height) ||
+      !node_map_->readInteger("OffsetX", &offset_x) || !node_map_->readInteger("OffsetY", &offset_y))
+  {
+    throw std::runtime_error("[Camera::readROI] Unable to read the ROI");
+  }
+  roi_width_ = width;
+  roi_height_ = height;
+  roi_x_offset_ = offset_x;
+  roi_y_offset_ = offset_y;
+}
+
+void Camera::configurationApplied(const SpinnakerConfig& config, bool success)
+{
+  config_applied_ = success;
+  unapplied_ = ConfigChanges();
+  if (success)
+    applied_config_ = config;
+}
+
+void Camera::keepImageFormat(SpinnakerConfig* config) const
+{
+  config->image_format_x_binning = applied_config_.image_format_x_binning;
+  config->image_format_y_binning = applied_config_.image_format_y_binning;
+  config->image_format_x_decimation = applied_config_.image_format_x_decimation;
+  config->image_format_y_decimation = applied_config_.image_format_y_decimation;
+  config->image_format_roi_width = applied_config_.image_format_roi_width;
+  config->image_format_roi_height = applied_config_.image_format_roi_height;
+  config->image_format_x_offset = applied_config_.image_format_x_offset;
+  config->image_format_y_offset = applied_config_.image_format_y_offset;
+  config->image_format_color_coding = applied_config_.image_format_color_coding;
 }
 
 // Image Size and Pixel Format
-void Camera::setImageControlFormats(const spinnaker_camera_driver::SpinnakerConfig& config)
+void Camera::setImageControlFormats(ConfigTransaction* transaction,
+                                    const spinnaker_camera_driver::SpinnakerConfig& config, ConfigChanges* skipped,
+                                    spinnaker_camera_driver::SpinnakerConfig* recorded)
 {
   // Set Binning and Decimation
-  setProperty(node_map_, "BinningHorizontal", config.image_format_x_binning);
-  setProperty(node_map_, "BinningVertical", config.image_format_y_binning);
-  setProperty(node_map_, "DecimationHorizontal", config.image_format_x_decimation);
-  setProperty(node_map_, "DecimationVertical", config.image_format_y_decimation);
+  ConfigChanges changes = ConfigChanges();
+  changes.image_format = true;
+  applyFeatures(IMAGE_FORMAT_FEATURES, model_, node_map_, transaction, config, changes, applied_config_, skipped,
+                recorded);
 
   // Grab the Max values after decimation
-  Spinnaker::GenApi::CIntegerPtr height_max_ptr = node_map_->GetNode("HeightMax");
-  if (!IsAvailable(height_max_ptr) || !IsReadable(height_max_ptr))
+  int64_t height_max;
+  if (!node_map_->readInteger("HeightMax", &height_max))
   {
     throw std::runtime_error("[Camera::setImageControlFormats] Unable to read HeightMax");
   }
-  height_max_ = height_max_ptr->GetValue();
-  Spinnaker::GenApi::CIntegerPtr width_max_ptr = node_map_->GetNode("WidthMax");
-  if (!IsAvailable(width_max_ptr) || !IsReadable(width_max_ptr))
+  height_max_ = height_max;
+  int64_t width_max;
+  if (!node_map_->readInteger("WidthMax", &width_max))
   {
     throw std::runtime_error("[Camera::setImageControlFormats] Unable to read WidthMax");
   }
-  width_max_ = width_max_ptr->GetValue();
+  width_max_ = width_max;
 
   // Offset first encase expanding ROI
   // Apply offset X
-  setProperty(node_map_, "OffsetX", 0);
+  transaction->set("OffsetX", 0);
   // Apply offset Y
-  setProperty(node_map_, "OffsetY", 0);
+  transaction->set("OffsetY", 0);
+  // Binning may have changed the size as well, applyROI only writes what differs from the camera
+  readROI();
 
-  setROI(config.image_format_x_offset, config.image_format_y_offset,
-         config.image_format_roi_width, config.image_format_roi_height);
+  if (!applyROI(transaction, config.image_format_x_offset, config.image_format_y_offset,
+                config.image_format_roi_width, config.image_format_roi_height))
+  {
+    skipped->image_format = true;
+  }
+  // Whatever the camera took, which is the clamped ROI if every write succeeded
+  recorded->image_format_roi_width = roi_width_;
+  recorded->image_format_roi_height = roi_height_;
+  recorded->image_format_x_offset = roi_x_offset_;
+  recorded->image_format_y_offset = roi_y_offset_;
 
   // Set Pixel Format
-  setProperty(node_map_, "PixelFormat", config.image_format_color_coding);
+  if (!transaction->set("PixelFormat", config.image_format_color_coding))
+  {
+    skipped->image_format = true;
+    recorded->image_format_color_coding = applied_config_.image_format_color_coding;
+  }
 }
 
 void Camera::setROI(const int x_offset, const int y_offset, const int roi_width, const int roi_height)
 {
-  // Set Width/Height
-  if (roi_width != roi_width_)
+  try
   {
-    if (roi_width <= 0 || roi_width > width_max_)
+    // Undone when an exception leaves this scope before the commit
+    ConfigTransaction transaction(node_map_);
+    if (!applyROI(&transaction, x_offset, y_offset, roi_width, roi_height))
     {
-      setProperty(node_map_, "Width", width_max_);
-      roi_width_ = width_max_;
-    }
-    else
-    {
-      setProperty(node_map_, "Width", roi_width);
-      roi_width_ = roi_width;
+      // Leave the camera with the ROI it had rather than a mix of the two
+      transaction.rollback();
+      readROI();
+      recordROI();
+      throw std::runtime_error("[Camera::setROI] The camera did not take the ROI");
     }
+    transaction.commit();
   }
-  if (roi_height != roi_height_)
+  catch (const Spinnaker::Exception& e)
   {
-    if (roi_height <= 0 || roi_height > height_max_)
-    {
-      setProperty(node_map_, "Height", height_max_);
-      roi_height_ = height_max_;
-    }
-    else
-    {
-      setProperty(node_map_, "Height", roi_height);
-      roi_height_ = roi_height;
-    }
+    throw std::runtime_error("[Camera::setROI] Failed to set ROI: " + std::string(e.what()));
   }
+  recordROI();
+}
 
-  // Apply offset X
-  setProperty(node_map_, "OffsetX", x_offset);
-  roi_x_offset_ = x_offset;
-  // Apply offset Y
-  setProperty(node_map_, "OffsetY", y_offset);
-  roi_y_offset_ = y_offset;
+void Camera::recordROI()
+{
+  applied_config_.image_format_roi_width = roi_width_;
+  applied_config_.image_format_roi_height = roi_height_;
+  applied_config_.image_format_x_offset = roi_x_offset_;
+  applied_config_.image_format_y_offset = roi_y_offset_;
+}
+
+int Camera::clampROIWidth(const int roi_width) const
+{
+  return (roi_width <= 0 || roi_width > width_max_) ? width_max_ : roi_width;
+}
+
+int Camera::clampROIHeight(const int roi_height) const
+{
+  return (roi_height <= 0 || roi_height > height_max_) ? height_max_ : roi_height;
+}
+
+bool Camera::roiNeedsAcquisitionStop(const int roi_width, const int roi_height)
+{
+  const int width = clampROIWidth(roi_width);
+  const int height = clampROIHeight(roi_height);
+
+  // Most cameras lock the image size while streaming, which shows as the node not being writable
+  return (width != roi_width_ && !node_map_->isWritable("Width")) ||
+         (height != roi_height_ && !node_map_->isWritable("Height"));
+}
+
+bool Camera::applyROI(ConfigTransaction* transaction, const int x_offset, const int y_offset, const int roi_width,
+                      const int roi_height)
+{
+  const int width = clampROIWidth(roi_width);
+  const int height = clampROIHeight(roi_height);
+  bool written = true;
+
+  // Writes one value, keeping it in the cached ROI only if the camera took it
+  auto write = [&](const std::string& property_name, const int value, int* cached) {
+    if (transaction->set(property_name, value))
+      *cached = value;
+    else
+      written = false;
+  };
+
+  // Offset and size must fit the sensor after every single write, so a growing ROI moves first and a shrinking one
+  // is resized first. Unchanged values are not written, moving the ROI only touches the offsets.
+  const bool width_first = width < roi_width_;
+  if (width_first)
+    write("Width", width, &roi_width_);
+  if (x_offset != roi_x_offset_)
+    write("OffsetX", x_offset, &roi_x_offset_);
+  if (!width_first && width != roi_width_)
+    write("Width", width, &roi_width_);
+
+  const bool height_first = height < roi_height_;
+  if (height_first)
+    write("Height", height, &roi_height_);
+  if (y_offset != roi_y_offset_)
+    write("OffsetY", y_offset, &roi_y_offset_);
+  if (!height_first && height != roi_height_)
+    write("Height", height, &roi_height_);
+
+  return written;
 }
 
 void Camera::setGain(const float& gain)
 {
-  setProperty(node_map_, "GainAuto", "Off");
-  setProperty(node_map_, "Gain", static_cast<float>(gain));
+  ConfigTransaction transaction(node_map_);
+  transaction.set("GainAuto", "Off");
+  transaction.set("Gain", static_cast<float>(gain));
+  transaction.commit();
+  applied_config_.auto_gain = "Off";
+  applied_config_.gain = gain;
+  readWritten("Gain", &applied_config_.gain);
+}
+
+void Camera::restartOnceAutoModes()
+{
+  if (!config_applied_)
+    return;
+
+  ConfigTransaction transaction(node_map_);
+  if (applied_config_.exposure_auto == "Once")
+    transaction.set("ExposureAuto", "Once");
+  if (applied_config_.auto_gain == "Once")
+    transaction.set("GainAuto", "Once");
+  if (applied_config_.auto_white_balance == "Once")
+    transaction.set("BalanceWhiteAuto", "Once");
+  transaction.commit();
 }
 
 /*
@@ -337,17 +764,28 @@ int Camera::getROIHeight() const
 // float Camera::getCameraFrameRate()
 //{
 //}
+std::vector<std::string> Camera::featureNames() const
+{
+  // Besides the feature tables, the image size and ROI are read back and SpinnakerCamera uses the rest
+  std::vector<std::string> names = { "HeightMax", "WidthMax", "Width", "Height", "OffsetX", "OffsetY",
+                                     "PixelFormat", "DeviceLinkThroughputLimit", "UserSetSelector" };
+  addFeatureNames(IMAGE_FORMAT_FEATURES, model_, &names);
+  addFeatureNames(FEATURES, model_, &names);
+  return names;
+}
+
 Spinnaker::GenApi::CNodePtr Camera::readProperty(const Spinnaker::GenICam::gcstring property_name)
 {
-  Spinnaker::GenApi::CNodePtr ptr = node_map_->GetNode(property_name);
-  if (!Spinnaker::GenApi::IsAvailable(ptr) || !Spinnaker::GenApi::IsReadable(ptr))
+  Spinnaker::GenApi::CNodePtr ptr = node_map_->getNode(property_name);
+  if (!node_map_->isAvailable(property_name) || !Spinnaker::GenApi::IsReadable(ptr))
   {
     throw std::runtime_error("Unable to get parmeter " + property_name);
   }
   return ptr;
 }
 
-Camera::Camera(Spinnaker::GenApi::INodeMap* node_map)
+Camera::Camera(NodeCache* node_map, const CameraModel model)
+  : model_(model), config_applied_(false), unapplied_(ConfigChanges())
 {
   node_map_ = node_map;
   init();
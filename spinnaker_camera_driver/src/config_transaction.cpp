@@ -0,0 +1,252 @@
+/**
+Software License Agreement (BSD)
+
+\file      config_transaction.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "spinnaker_camera_driver/config_transaction.h"
+
+#include <ros/ros.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+namespace spinnaker_camera_driver
+{
+namespace
+{
+/*!
+* \brief Writes value clamped to the limits of the node.
+*
+* A value within the probed limits is written without reading the limits from the camera. Anything else, and a value
+* the camera rejects, is clamped to the current limits, since some move with other settings: the maximum ExposureTime
+* follows the frame rate.
+*/
+template <typename PointerT, typename ValueT>
+ValueT writeClamped(PointerT& node, ValueT value, const NodeCache::Capability& capability)
+{
+  if (capability.has_range && value >= capability.min && value <= capability.max)
+  {
+    try
+    {
+      node->SetValue(value);
+      return value;
+    }
+    catch (const Spinnaker::Exception& e)
+    {
+      // Fall through to the current limits
+    }
+  }
+  value = std::min<ValueT>(std::max<ValueT>(value, node->GetMin()), node->GetMax());
+  node->SetValue(value);
+  return value;
+}
+}  // namespace
+
+ConfigTransaction::ConfigTransaction(NodeCache* node_map) : node_map_(node_map), done_(false)
+{
+}
+
+ConfigTransaction::~ConfigTransaction()
+{
+  if (!done_)
+    rollback();
+}
+
+bool ConfigTransaction::set(const std::string& property_name, const std::string& entry_name)
+{
+  NodeCache::Capability capability;
+  Spinnaker::GenApi::CEnumerationPtr enumeration_ptr = writableNode(property_name, &capability);
+  if (!enumeration_ptr)
+    return false;
+
+  if (!capability.entries.empty() &&
+      std::find(capability.entries.begin(), capability.entries.end(), entry_name) == capability.entries.end())
+  {
+    skipped_.push_back(property_name + " (entry " + entry_name + " not implemented)");
+    return false;
+  }
+  Spinnaker::GenApi::CEnumEntryPtr entry_ptr = enumeration_ptr->GetEntryByName(entry_name.c_str());
+  if (!Spinnaker::GenApi::IsAvailable(entry_ptr) || !Spinnaker::GenApi::IsReadable(entry_ptr))
+  {
+    skipped_.push_back(property_name + " (entry " + entry_name + " not available)");
+    return false;
+  }
+
+  const Spinnaker::GenICam::gcstring previous = enumeration_ptr->ToString();
+  enumeration_ptr->SetIntValue(entry_ptr->GetValue());
+  record(property_name, enumeration_ptr, previous, entry_name);
+  return true;
+}
+
+bool ConfigTransaction::set(const std::string& property_name, const char* entry_name)
+{
+  // Without this overload a string literal would convert to bool rather than std::string
+  return set(property_name, std::string(entry_name));
+}
+
+bool ConfigTransaction::set(const std::string& property_name, float value)
+{
+  NodeCache::Capability capability;
+  Spinnaker::GenApi::CFloatPtr float_ptr = writableNode(property_name, &capability);
+  if (!float_ptr)
+    return false;
+
+  const Spinnaker::GenICam::gcstring previous = float_ptr->ToString();
+  value = writeClamped(float_ptr, value, capability);
+
+  std::ostringstream written;
+  written << value;
+  record(property_name, float_ptr, previous, written.str());
+  return true;
+}
+
+bool ConfigTransaction::set(const std::string& property_name, int value)
+{
+  NodeCache::Capability capability;
+  Spinnaker::GenApi::CIntegerPtr int_ptr = writableNode(property_name, &capability);
+  if (!int_ptr)
+    return false;
+
+  const Spinnaker::GenICam::gcstring previous = int_ptr->ToString();
+  value = writeClamped(int_ptr, value, capability);
+  record(property_name, int_ptr, previous, std::to_string(value));
+  return true;
+}
+
+bool ConfigTransaction::set(const std::string& property_name, bool value)
+{
+  NodeCache::Capability capability;
+  Spinnaker::GenApi::CBooleanPtr bool_ptr = writableNode(property_name, &capability);
+  if (!bool_ptr)
+    return false;
+
+  const Spinnaker::GenICam::gcstring previous = bool_ptr->ToString();
+  bool_ptr->SetValue(value);
+  record(property_name, bool_ptr, previous, value ? "true" : "false");
+  return true;
+}
+
+bool ConfigTransaction::setMax(const std::string& property_name)
+{
+  NodeCache::Capability capability;
+  Spinnaker::GenApi::CIntegerPtr int_ptr = writableNode(property_name, &capability);
+  if (!int_ptr)
+    return false;
+
+  const Spinnaker::GenICam::gcstring previous = int_ptr->ToString();
+  const int64_t value = int_ptr->GetMax();
+  int_ptr->SetValue(value);
+  record(property_name, int_ptr, previous, std::to_string(value));
+  return true;
+}
+
+void ConfigTransaction::commit()
+{
+  done_ = true;
+
+  if (!writes_.empty())
+  {
+    std::ostringstream summary;
+    const char* separator = "";
+    for (const Write& write : writes_)
+    {
+      summary << separator << write.property_name << "=" << write.value;
+      separator = ", ";
+    }
+    ROS_INFO_STREAM("[SpinnakerCamera]: (" << node_map_->id() << ") Set " << writes_.size()
+                    << " properties: " << summary.str());
+  }
+  if (!skipped_.empty())
+  {
+    std::ostringstream summary;
+    const char* separator = "";
+    for (const std::string& skipped : skipped_)
+    {
+      summary << separator << skipped;
+      separator = ", ";
+    }
+    ROS_WARN_STREAM("[SpinnakerCamera]: (" << node_map_->id() << ") Skipped " << skipped_.size()
+                    << " properties: " << summary.str());
+  }
+}
+
+void ConfigTransaction::rollback()
+{
+  done_ = true;
+  if (writes_.empty())
+    return;
+
+  size_t restored = 0;
+  for (std::vector<Write>::reverse_iterator write = writes_.rbegin(); write != writes_.rend(); ++write)
+  {
+    // Keep going, the earlier writes are still worth undoing
+    try
+    {
+      write->node->FromString(write->previous);
+      restored++;
+    }
+    catch (const Spinnaker::Exception& e)
+    {
+      ROS_ERROR_STREAM("[SpinnakerCamera]: (" << node_map_->id() << ") Could not restore " << write->property_name
+                       << " to " << write->previous << ": " << e.what());
+    }
+  }
+  ROS_WARN_STREAM("[SpinnakerCamera]: (" << node_map_->id() << ") Configuration failed, restored " << restored << " of "
+                  << writes_.size() << " properties");
+  writes_.clear();
+}
+
+Spinnaker::GenApi::CNodePtr ConfigTransaction::writableNode(const std::string& property_name,
+                                                            NodeCache::Capability* capability)
+{
+  Spinnaker::GenApi::CNodePtr node = node_map_->getNode(property_name.c_str());
+
+  // Whether the camera implements a feature does not change while connected, the rest can change with other settings
+  if (!node_map_->getCapability(property_name, capability))
+  {
+    capability->implemented = Spinnaker::GenApi::IsImplemented(node);
+    capability->has_range = false;
+  }
+
+  if (!capability->implemented)
+    skipped_.push_back(property_name + " (not implemented)");
+  else if (!Spinnaker::GenApi::IsAvailable(node))
+    skipped_.push_back(property_name + " (not available)");
+  else if (!Spinnaker::GenApi::IsWritable(node))
+    skipped_.push_back(property_name + " (not writable)");
+  else
+    return node;
+  return 0;
+}
+
+void ConfigTransaction::record(const std::string& property_name, Spinnaker::GenApi::INode* node,
+                               const Spinnaker::GenICam::gcstring& previous, const std::string& value)
+{
+  Write write;
+  write.property_name = property_name;
+  write.node = node;
+  write.previous = previous;
+  write.value = value;
+  writes_.push_back(write);
+}
+}  // namespace spinnaker_camera_driver
@@ -0,0 +1,165 @@
+/**
+Software License Agreement (BSD)
+
+\file      debayer.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "spinnaker_camera_driver/debayer.h"
+
+#include <sensor_msgs/image_encodings.h>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <string>
+
+namespace spinnaker_camera_driver
+{
+namespace
+{
+struct BayerCodes
+{
+  int bgr;
+  int rgb;
+  int bgr_edge_aware;
+  int rgb_edge_aware;
+  int gray;
+};
+
+/// OpenCV names Bayer patterns after the second row, so a ROS rggb image is an OpenCV BayerBG image.
+bool bayerCodes(const std::string& encoding, BayerCodes* codes)
+{
+  namespace enc = sensor_msgs::image_encodings;
+
+  if (encoding == enc::BAYER_RGGB8 || encoding == enc::BAYER_RGGB16)
+  {
+    *codes = { cv::COLOR_BayerBG2BGR, cv::COLOR_BayerBG2RGB, cv::COLOR_BayerBG2BGR_EA, cv::COLOR_BayerBG2RGB_EA,
+               cv::COLOR_BayerBG2GRAY };
+  }
+  else if (encoding == enc::BAYER_BGGR8 || encoding == enc::BAYER_BGGR16)
+  {
+    *codes = { cv::COLOR_BayerRG2BGR, cv::COLOR_BayerRG2RGB, cv::COLOR_BayerRG2BGR_EA, cv::COLOR_BayerRG2RGB_EA,
+               cv::COLOR_BayerRG2GRAY };
+  }
+  else if (encoding == enc::BAYER_GBRG8 || encoding == enc::BAYER_GBRG16)
+  {
+    *codes = { cv::COLOR_BayerGR2BGR, cv::COLOR_BayerGR2RGB, cv::COLOR_BayerGR2BGR_EA, cv::COLOR_BayerGR2RGB_EA,
+               cv::COLOR_BayerGR2GRAY };
+  }
+  else if (encoding == enc::BAYER_GRBG8 || encoding == enc::BAYER_GRBG16)
+  {
+    *codes = { cv::COLOR_BayerGB2BGR, cv::COLOR_BayerGB2RGB, cv::COLOR_BayerGB2BGR_EA, cv::COLOR_BayerGB2RGB_EA,
+               cv::COLOR_BayerGB2GRAY };
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+/// Sizes dst for the given encoding and wraps its data, so OpenCV writes into the message directly.
+cv::Mat prepareOutput(const sensor_msgs::Image& raw, const std::string& encoding, sensor_msgs::Image* dst)
+{
+  const int depth = sensor_msgs::image_encodings::bitDepth(encoding) == 16 ? CV_16U : CV_8U;
+  const int channels = sensor_msgs::image_encodings::numChannels(encoding);
+
+  dst->header = raw.header;
+  dst->encoding = encoding;
+  dst->height = raw.height;
+  dst->width = raw.width;
+  dst->step = raw.width * channels * (depth == CV_16U ? 2 : 1);
+  dst->is_bigendian = raw.is_bigendian;
+  dst->data.resize(static_cast<size_t>(dst->step) * dst->height);
+
+  return cv::Mat(dst->height, dst->width, CV_MAKETYPE(depth, channels), dst->data.data(), dst->step);
+}
+
+cv::Mat wrapInput(const sensor_msgs::Image& raw)
+{
+  const int depth = sensor_msgs::image_encodings::bitDepth(raw.encoding) == 16 ? CV_16U : CV_8U;
+  const int channels = sensor_msgs::image_encodings::numChannels(raw.encoding);
+  return cv::Mat(raw.height, raw.width, CV_MAKETYPE(depth, channels), const_cast<uint8_t*>(raw.data.data()),
+                 raw.step);
+}
+}  // namespace
+
+Debayer::Debayer(const Algorithm algorithm, const bool rgb) : algorithm_(algorithm), rgb_(rgb)
+{
+}
+
+bool Debayer::toColor(const sensor_msgs::Image& raw, sensor_msgs::Image* color) const
+{
+  namespace enc = sensor_msgs::image_encodings;
+
+  BayerCodes codes;
+  if (!bayerCodes(raw.encoding, &codes))
+    return false;
+
+  int code;
+  if (algorithm_ == EDGE_AWARE)
+    code = rgb_ ? codes.rgb_edge_aware : codes.bgr_edge_aware;
+  else
+    code = rgb_ ? codes.rgb : codes.bgr;
+
+  const bool sixteen_bit = enc::bitDepth(raw.encoding) == 16;
+  const std::string encoding = rgb_ ? (sixteen_bit ? enc::RGB16 : enc::RGB8) : (sixteen_bit ? enc::BGR16 : enc::BGR8);
+
+  cv::Mat dst = prepareOutput(raw, encoding, color);
+  cv::cvtColor(wrapInput(raw), dst, code);
+  return true;
+}
+
+bool Debayer::toMono(const sensor_msgs::Image& raw, sensor_msgs::Image* mono) const
+{
+  namespace enc = sensor_msgs::image_encodings;
+
+  int code;
+  BayerCodes codes;
+  if (bayerCodes(raw.encoding, &codes))
+    code = codes.gray;
+  else if (raw.encoding == enc::RGB8 || raw.encoding == enc::RGB16)
+    code = cv::COLOR_RGB2GRAY;
+  else if (raw.encoding == enc::BGR8 || raw.encoding == enc::BGR16)
+    code = cv::COLOR_BGR2GRAY;
+  else if (raw.encoding == enc::RGBA8 || raw.encoding == enc::RGBA16)
+    code = cv::COLOR_RGBA2GRAY;
+  else if (raw.encoding == enc::BGRA8 || raw.encoding == enc::BGRA16)
+    code = cv::COLOR_BGRA2GRAY;
+  else
+    return false;
+
+  cv::Mat dst = prepareOutput(raw, enc::bitDepth(raw.encoding) == 16 ? enc::MONO16 : enc::MONO8, mono);
+  cv::cvtColor(wrapInput(raw), dst, code);
+  return true;
+}
+
+bool Debayer::parseAlgorithm(const std::string& name, Algorithm* algorithm)
+{
+  if (name == "bilinear")
+    *algorithm = BILINEAR;
+  else if (name == "edge_aware")
+    *algorithm = EDGE_AWARE;
+  else
+    return false;
+  return true;
+}
+}  // namespace spinnaker_camera_driver
@@ -72,6 +72,12 @@ void DiagnosticsManager::addDiagnostic(const Spinnaker::GenICam::gcstring name,
   float_params_.push_back(param);
 }
 
+void DiagnosticsManager::addStreamDiagnostic(const Spinnaker::GenICam::gcstring name)
+{
+  diagnostic_params<int> param{ name, false, std::make_pair(0, 0), 0, 0 };
+  stream_params_.push_back(param);
+}
+
 template <typename T>
 diagnostic_msgs::DiagnosticStatus DiagnosticsManager::getDiagStatus(const diagnostic_params<T>& param, const T value)
 {
@@ -149,6 +155,19 @@ void DiagnosticsManager::processDiagnostics(SpinnakerCamera* spinnaker)
     diag_array.status.push_back(diag_status);
   }
 
+  // Stream (host side buffer) parameters
+  for (const diagnostic_params<int>& param : stream_params_)
+  {
+    Spinnaker::GenApi::CIntegerPtr integer_ptr =
+        static_cast<Spinnaker::GenApi::CIntegerPtr>(spinnaker->readStreamProperty(param.parameter_name));
+    if (!integer_ptr)
+      continue;
+
+    int int_value = integer_ptr->GetValue(true);
+    diagnostic_msgs::DiagnosticStatus diag_status = getDiagStatus(param, int_value);
+    diag_array.status.push_back(diag_status);
+  }
+
   diagnostics_pub_->publish(diag_array);
 }
 }  // namespace spinnaker_camera_driver
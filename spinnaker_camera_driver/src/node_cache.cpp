@@ -0,0 +1,195 @@
+/**
+Software License Agreement (BSD)
+
+\file      node_cache.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "spinnaker_camera_driver/node_cache.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace spinnaker_camera_driver
+{
+NodeCache::NodeCache(Spinnaker::GenApi::INodeMap* node_map) : node_map_(node_map), lookups_(0), hits_(0)
+{
+}
+
+Spinnaker::GenApi::CNodePtr NodeCache::getNode(const Spinnaker::GenICam::gcstring& name)
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  return lookup(name.c_str());
+}
+
+void NodeCache::probe(const std::vector<std::string>& names)
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  capabilities_.clear();
+  for (const std::string& name : names)
+  {
+    Spinnaker::GenApi::CNodePtr node = lookup(name);
+
+    Capability capability;
+    capability.type = Spinnaker::GenApi::intfIBase;
+    capability.implemented = Spinnaker::GenApi::IsImplemented(node);
+    capability.available = capability.implemented && Spinnaker::GenApi::IsAvailable(node);
+    capability.writable = capability.available && Spinnaker::GenApi::IsWritable(node);
+    capability.has_range = false;
+    capability.min = 0.0;
+    capability.max = 0.0;
+    if (capability.implemented)
+    {
+      capability.type = node->GetPrincipalInterfaceType();
+      const bool readable = capability.available && Spinnaker::GenApi::IsReadable(node);
+      if (readable && capability.type == Spinnaker::GenApi::intfIFloat)
+      {
+        Spinnaker::GenApi::CFloatPtr float_ptr = node;
+        capability.has_range = true;
+        capability.min = float_ptr->GetMin();
+        capability.max = float_ptr->GetMax();
+      }
+      else if (readable && capability.type == Spinnaker::GenApi::intfIInteger)
+      {
+        Spinnaker::GenApi::CIntegerPtr int_ptr = node;
+        capability.has_range = true;
+        capability.min = int_ptr->GetMin();
+        capability.max = int_ptr->GetMax();
+      }
+      else if (capability.type == Spinnaker::GenApi::intfIEnumeration)
+      {
+        Spinnaker::GenApi::CEnumerationPtr enumeration_ptr = node;
+        Spinnaker::GenApi::NodeList_t entries;
+        enumeration_ptr->GetEntries(entries);
+        for (Spinnaker::GenApi::INode* entry : entries)
+        {
+          Spinnaker::GenApi::CEnumEntryPtr entry_ptr = entry;
+          if (Spinnaker::GenApi::IsImplemented(entry_ptr))
+            capability.entries.push_back(entry_ptr->GetSymbolic().c_str());
+        }
+      }
+    }
+    capabilities_[name] = capability;
+  }
+}
+
+bool NodeCache::getCapability(const std::string& name, Capability* capability) const
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  std::map<std::string, Capability>::const_iterator found = capabilities_.find(name);
+  if (found == capabilities_.end())
+    return false;
+  *capability = found->second;
+  return true;
+}
+
+std::vector<std::pair<std::string, NodeCache::Capability> > NodeCache::getCapabilities() const
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  return std::vector<std::pair<std::string, Capability> >(capabilities_.begin(), capabilities_.end());
+}
+
+bool NodeCache::isAvailable(const Spinnaker::GenICam::gcstring& name)
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  std::map<std::string, Capability>::const_iterator found = capabilities_.find(name.c_str());
+  if (found != capabilities_.end() && !found->second.implemented)
+    return false;
+  return Spinnaker::GenApi::IsAvailable(lookup(name.c_str()));
+}
+
+bool NodeCache::isImplemented(const Spinnaker::GenICam::gcstring& name)
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  std::map<std::string, Capability>::const_iterator found = capabilities_.find(name.c_str());
+  if (found != capabilities_.end())
+    return found->second.implemented;
+  return Spinnaker::GenApi::IsImplemented(lookup(name.c_str()));
+}
+
+bool NodeCache::isWritable(const Spinnaker::GenICam::gcstring& name)
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  return Spinnaker::GenApi::IsWritable(lookup(name.c_str()));
+}
+
+bool NodeCache::readInteger(const Spinnaker::GenICam::gcstring& name, int64_t* value)
+{
+  Spinnaker::GenApi::CIntegerPtr int_ptr = getNode(name);
+  if (!Spinnaker::GenApi::IsAvailable(int_ptr) || !Spinnaker::GenApi::IsReadable(int_ptr))
+    return false;
+  *value = int_ptr->GetValue();
+  return true;
+}
+
+bool NodeCache::readFloat(const Spinnaker::GenICam::gcstring& name, double* value)
+{
+  Spinnaker::GenApi::CFloatPtr float_ptr = getNode(name);
+  if (!Spinnaker::GenApi::IsAvailable(float_ptr) || !Spinnaker::GenApi::IsReadable(float_ptr))
+    return false;
+  *value = float_ptr->GetValue();
+  return true;
+}
+
+const std::string& NodeCache::id()
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  if (id_.empty())
+  {
+    Spinnaker::GenApi::CStringPtr id_ptr = lookup("DeviceID");
+    if (!Spinnaker::GenApi::IsAvailable(id_ptr) || !Spinnaker::GenApi::IsReadable(id_ptr))
+      id_ptr = lookup("StreamID");
+    if (Spinnaker::GenApi::IsAvailable(id_ptr) && Spinnaker::GenApi::IsReadable(id_ptr))
+      id_ = id_ptr->GetValue().c_str();
+    else
+      id_ = "unknown";
+  }
+  return id_;
+}
+
+uint64_t NodeCache::lookups() const
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  return lookups_;
+}
+
+uint64_t NodeCache::hits() const
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  return hits_;
+}
+
+Spinnaker::GenApi::CNodePtr NodeCache::lookup(const std::string& name)
+{
+  std::unordered_map<std::string, Spinnaker::GenApi::CNodePtr>::const_iterator cached = nodes_.find(name);
+  if (cached != nodes_.end())
+  {
+    hits_++;
+    return cached->second;
+  }
+
+  lookups_++;
+  Spinnaker::GenApi::CNodePtr node = node_map_->GetNode(name.c_str());
+  nodes_.insert(std::make_pair(name, node));
+  return node;
+}
+}  // namespace spinnaker_camera_driver
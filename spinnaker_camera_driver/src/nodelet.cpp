@@ -52,7 +52,13 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <nodelet/nodelet.h>
 
 #include "spinnaker_camera_driver/SpinnakerCamera.h"  // The actual standalone library for the Spinnakers
+#include "spinnaker_camera_driver/debayer.h"
 #include "spinnaker_camera_driver/diagnostics.h"
+#include "spinnaker_camera_driver/frame_ring.h"
+#include "spinnaker_camera_driver/frame_synchronizer.h"
+#include "spinnaker_camera_driver/message_pool.h"
+#include "spinnaker_camera_driver/thread_scheduling.h"
+#include "spinnaker_camera_driver/timestamp_estimator.h"
 
 #include <image_transport/image_transport.h>          // ROS library that allows sending compressed images
 #include <camera_info_manager/camera_info_manager.h>  // ROS library that publishes CameraInfo topics
@@ -63,13 +69,23 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <diagnostic_updater/diagnostic_updater.h>  // Headers for publishing diagnostic messages.
 #include <diagnostic_updater/publisher.h>
+#include <diagnostic_msgs/DiagnosticStatus.h>
 
-#include <boost/thread.hpp>  // Needed for the nodelet to launch the reading thread.
+#include <boost/shared_ptr.hpp>  // Atomic swaps of the shared CameraInfo.
+#include <boost/thread.hpp>      // Needed for the nodelet to launch the reading thread.
 
 #include <dynamic_reconfigure/server.h>  // Needed for the dynamic_reconfigure gui service to run
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace spinnaker_camera_driver
 {
@@ -90,10 +106,16 @@ public:
       diagThread_->join();
     }
 
-    if (pubThread_)
+    if (publishThread_)
     {
-      pubThread_->interrupt();
-      pubThread_->join();
+      publishThread_->interrupt();
+      publishThread_->join();
+    }
+
+    if (grabThread_)
+    {
+      grabThread_->interrupt();
+      grabThread_->join();
 
       try
       {
@@ -109,58 +131,148 @@ public:
     }
   }
 
-private:
+  typedef boost::function<void(const wfov_camera_msgs::WFOVImagePtr&)> FrameSink;
+
   /*!
-  * \brief Function that allows reconfiguration of the camera.
+  * \brief Hands every frame to sink instead of publishing it, e.g. to synchronize it with other cameras first.
   *
-  * This function serves as a callback for the dynamic reconfigure service.  It simply passes the configuration object
-  * to the driver to allow the camera to reconfigure.
-  * \param config  camera_library::CameraConfig object passed by reference.  Values will be changed to those the driver
-  * is currently using.
-  * \param level driver_base reconfiguration level.  See driver_base/SensorLevels.h for more information.
+  * Must be called before init(). The sink runs on the publishing thread and publishes frames through publishFrame.
   */
+  void setFrameSink(const FrameSink& sink)
+  {
+    frame_sink_ = sink;
+  }
+
+  /// Publishes a frame that went through the frame sink. Calls must be serialized.
+  void publishFrame(const wfov_camera_msgs::WFOVImagePtr& wfov_image)
+  {
+    publishImage(wfov_image);
+  }
+
+private:
+  /// What the image metadata and the CameraInfo derive from the configuration.
+  struct ImageSettings
+  {
+    ImageSettings()
+      : gain(0.0)
+      , wb_blue(0)
+      , wb_red(0)
+      , binning_x(1)
+      , binning_y(1)
+      , roi_x_offset(0)
+      , roi_y_offset(0)
+      , roi_height(0)
+      , roi_width(0)
+      , do_rectify(false)
+    {
+    }
 
+    double gain;
+    uint16_t wb_blue;
+    uint16_t wb_red;
+
+    // Parameters for cameraInfo
+    size_t binning_x;     ///< Camera Info pixel binning along the image x axis.
+    size_t binning_y;     ///< Camera Info pixel binning along the image y axis.
+    size_t roi_x_offset;  ///< Camera Info ROI x offset
+    size_t roi_y_offset;  ///< Camera Info ROI y offset
+    size_t roi_height;    ///< Camera Info ROI height
+    size_t roi_width;     ///< Camera Info ROI width
+    bool do_rectify;  ///< Whether or not to rectify as if part of an image.  Set to false if whole image, and true if
+                      /// in ROI mode.
+  };
+
+  /*!
+  * \brief Queues a configuration for devicePoll to apply between frames.
+  *
+  * Dragging a slider in rqt_reconfigure sends dozens of configurations a second. Only the latest one waiting is
+  * applied, with the levels of every configuration it replaced, so that a burst costs one reconfigure rather than
+  * blocking frame grabs for each of them. This never touches the camera, not even for the first configuration that
+  * dynamic_reconfigure hands over from onInit: devicePoll writes whatever is queued whole once it has connected,
+  * inside a connect slot, so that cameras loaded together connect in parallel.
+  */
   void paramCallback(const spinnaker_camera_driver::SpinnakerConfig& config, uint32_t level)
   {
+    NODELET_DEBUG_ONCE("Dynamic reconfigure callback with level: %u", level);
+    std::lock_guard<std::mutex> scopedLock(config_mutex_);
     config_ = config;
+    if (config_pending_)
+      reconfigures_coalesced_++;
+    else
+      config_requested_ = ros::WallTime::now();
+    config_pending_ = true;
+    pending_level_ |= level;
+  }
 
-    try
+  /*!
+  * \brief Applies what paramCallback, gainWBCallback and roiCallback queued last, if anything.
+  *
+  * Called by devicePoll between frames, so that no update competes with a frame grab for the camera.
+  */
+  void applyPendingConfiguration()
+  {
+    spinnaker_camera_driver::SpinnakerConfig config;
+    uint32_t level = 0;
+    image_exposure_msgs::ExposureSequence exposure;
+    sensor_msgs::RegionOfInterest roi;
+    bool config_pending;
+    bool exposure_pending;
+    bool roi_pending;
     {
-      NODELET_DEBUG_ONCE("Dynamic reconfigure callback with level: %u", level);
-      spinnaker_.setNewConfiguration(config, level);
-
-      // Store needed parameters for the metadata message
-      gain_ = config.gain;
-      wb_blue_ = config.white_balance_blue_ratio;
-      wb_red_ = config.white_balance_red_ratio;
-
-      // No separate param in CameraInfo for binning/decimation
-      binning_x_ = config.image_format_x_binning * config.image_format_x_decimation;
-      binning_y_ = config.image_format_y_binning * config.image_format_y_decimation;
-
-      // Store CameraInfo RegionOfInterest information
-      // TODO(mhosmar): Not compliant with CameraInfo message: "A particular ROI always denotes the
-      //                same window of pixels on the camera sensor, regardless of binning settings."
-      //                These values are in the post binned frame.
-      if ((config.image_format_roi_width + config.image_format_roi_height) > 0 &&
-          (config.image_format_roi_width < spinnaker_.getWidthMax() ||
-           config.image_format_roi_height < spinnaker_.getHeightMax()))
+      std::lock_guard<std::mutex> scopedLock(config_mutex_);
+      config_pending = config_pending_;
+      exposure_pending = exposure_pending_;
+      roi_pending = roi_pending_;
+      if (config_pending)
       {
-        roi_x_offset_ = config.image_format_x_offset;
-        roi_y_offset_ = config.image_format_y_offset;
-        roi_width_ = config.image_format_roi_width;
-        roi_height_ = config.image_format_roi_height;
-        do_rectify_ = true;  // Set to true if an ROI is used.
+        config = config_;
+        level = pending_level_;
+        config_pending_ = false;
+        pending_level_ = 0;
+        last_reconfigure_wait_ = (ros::WallTime::now() - config_requested_).toSec();
       }
-      else
+      if (exposure_pending)
       {
-        // Zeros mean the full resolution was captured.
-        roi_x_offset_ = 0;
-        roi_y_offset_ = 0;
-        roi_height_ = 0;
-        roi_width_ = 0;
-        do_rectify_ = false;  // Set to false if the whole image is captured.
+        exposure = pending_exposure_;
+        exposure_pending_ = false;
       }
+      if (roi_pending)
+      {
+        roi = pending_roi_;
+        roi_pending_ = false;
+      }
+    }
+    if (config_pending)
+      applyConfiguration(config, level);
+    if (exposure_pending)
+      applyExposure(exposure);
+    if (roi_pending)
+      applyRegionOfInterest(roi);
+  }
+
+  /// Takes the latest configuration for a fresh connection, which applies it whole, so nothing stays queued.
+  spinnaker_camera_driver::SpinnakerConfig takeConfiguration()
+  {
+    std::lock_guard<std::mutex> scopedLock(config_mutex_);
+    config_pending_ = false;
+    pending_level_ = 0;
+    return config_;
+  }
+
+  /// Writes a configuration to the camera and updates what the published messages derive from it.
+  void applyConfiguration(const spinnaker_camera_driver::SpinnakerConfig& config, uint32_t level)
+  {
+    try
+    {
+      const ros::WallTime start = ros::WallTime::now();
+      spinnaker_.setNewConfiguration(config, level);
+      const double latency = (ros::WallTime::now() - start).toSec();
+      last_reconfigure_latency_ = latency;
+      max_reconfigure_latency_ = std::max(max_reconfigure_latency_.load(), latency);
+      reconfigures_++;
+      NODELET_DEBUG("Reconfigure with level %u took %.1f ms", level, 1e3 * latency);
+
+      configurationApplied(config);
     }
     catch (std::runtime_error& e)
     {
@@ -168,6 +280,47 @@ private:
     }
   }
 
+  /// Updates the image metadata, ROI and CameraInfo after the camera took a configuration.
+  void configurationApplied(const spinnaker_camera_driver::SpinnakerConfig& config)
+  {
+    ImageSettings settings = imageSettings();
+
+    // Store needed parameters for the metadata message
+    settings.gain = config.gain;
+    settings.wb_blue = config.white_balance_blue_ratio;
+    settings.wb_red = config.white_balance_red_ratio;
+
+    // No separate param in CameraInfo for binning/decimation
+    settings.binning_x = config.image_format_x_binning * config.image_format_x_decimation;
+    settings.binning_y = config.image_format_y_binning * config.image_format_y_decimation;
+
+    // Store CameraInfo RegionOfInterest information
+    // TODO(mhosmar): Not compliant with CameraInfo message: "A particular ROI always denotes the
+    //                same window of pixels on the camera sensor, regardless of binning settings."
+    //                These values are in the post binned frame.
+    if ((config.image_format_roi_width + config.image_format_roi_height) > 0 &&
+        (config.image_format_roi_width < spinnaker_.getWidthMax() ||
+         config.image_format_roi_height < spinnaker_.getHeightMax()))
+    {
+      settings.roi_x_offset = config.image_format_x_offset;
+      settings.roi_y_offset = config.image_format_y_offset;
+      settings.roi_width = config.image_format_roi_width;
+      settings.roi_height = config.image_format_roi_height;
+      settings.do_rectify = true;  // Set to true if an ROI is used.
+    }
+    else
+    {
+      // Zeros mean the full resolution was captured.
+      settings.roi_x_offset = 0;
+      settings.roi_y_offset = 0;
+      settings.roi_height = 0;
+      settings.roi_width = 0;
+      settings.do_rectify = false;  // Set to false if the whole image is captured.
+    }
+
+    setImageSettings(settings);
+  }
+
   void diagCb()
   {
     if (!diagThread_)  // We need to connect
@@ -185,63 +338,41 @@ private:
   */
   void connectCb()
   {
-    if (!pubThread_)  // We need to connect
-    {
-      // Start the thread to loop through and publish messages
-      pubThread_.reset(
-          new boost::thread(boost::bind(&spinnaker_camera_driver::SpinnakerCameraNodelet::devicePoll, this)));
-    }
-
-    // @tthomas - removing subscriber check and logic below as it's leading to mutex locks and crashes currently
-    /*
     NODELET_DEBUG_ONCE("Connect callback!");
-    std::lock_guard<std::mutex> scopedLock(connect_mutex_); // Grab the mutex.  Wait until we're done initializing
-    before letting this function through.
-    // Check if we should disconnect (there are 0 subscribers to our data)
-    if(it_pub_.getNumSubscribers() == 0 && pub_->getPublisher().getNumSubscribers() == 0)
-    {
-      if (pubThread_)
-      {
-        NODELET_DEBUG_ONCE("Disconnecting.");
-        pubThread_->interrupt();
-        scopedLock.unlock();
-        pubThread_->join();
-        scopedLock.lock();
-        pubThread_.reset();
-        sub_.shutdown();
-
-        try
-        {
-          NODELET_DEBUG_ONCE("Stopping camera capture.");
-          spinnaker_.stop();
-        }
-        catch(std::runtime_error& e)
-        {
-          NODELET_ERROR("%s", e.what());
-        }
+    std::lock_guard<std::mutex> scopedLock(connect_mutex_);  // Grab the mutex.  Wait until we're done initializing
+                                                             // before letting this function through.
 
-        try
-        {
-          NODELET_DEBUG_ONCE("Disconnecting from camera.");
-          spinnaker_.disconnect();
-        }
-        catch(std::runtime_error& e)
-        {
-          NODELET_ERROR("%s", e.what());
-        }
-      }
-    }
-    else if(!pubThread_)     // We need to connect
+    // Only record whether anyone is listening and let the threads act on it. Stopping and joining them from here
+    // deadlocked, since they may be waiting on connect_mutex_ themselves.
     {
-      // Start the thread to loop through and publish messages
-      pubThread_.reset(new boost::thread(boost::bind(&spinnaker_camera_driver::SpinnakerCameraNodelet::devicePoll,
-    this)));
+      boost::lock_guard<boost::mutex> subscriberLock(subscriber_mutex_);
+      has_subscribers_ = countSubscribers() > 0;
     }
-    else
+    subscriber_cv_.notify_all();
+
+    startThreads();
+  }
+
+  /// Starts the grab and publish threads unless they are running already. Must be called with connect_mutex_ held.
+  void startThreads()
+  {
+    if (!grabThread_)  // We need to connect
     {
-      NODELET_DEBUG_ONCE("Do nothing in callback.");
+      // Start the thread that publishes what the grab thread queues up, then the grab thread itself
+      publishThread_.reset(
+          new boost::thread(boost::bind(&spinnaker_camera_driver::SpinnakerCameraNodelet::publishPoll, this)));
+      grabThread_.reset(
+          new boost::thread(boost::bind(&spinnaker_camera_driver::SpinnakerCameraNodelet::devicePoll, this)));
     }
-    */
+  }
+
+  /// Number of subscribers across every topic the frames are published on.
+  uint32_t countSubscribers()
+  {
+    uint32_t subscribers = it_pub_.getNumSubscribers() + pub_->getPublisher().getNumSubscribers();
+    if (debayer_)
+      subscribers += it_pub_color_.getNumSubscribers() + it_pub_mono_.getNumSubscribers();
+    return subscribers;
   }
 
   /*!
@@ -252,6 +383,16 @@ private:
   */
   void onInit()
   {
+    init_time_ = ros::WallTime::now();
+    time_to_first_frame_ = 0.0;
+    first_frame_pending_ = false;
+    removals_seen_ = 0;
+    lost_time_ = 0.0;
+    recoveries_ = 0;
+    last_recovery_ = 0.0;
+    max_recovery_ = 0.0;
+    total_recovery_ = 0.0;
+
     // Get nodeHandles
     ros::NodeHandle& nh = getMTNodeHandle();
     ros::NodeHandle& pnh = getMTPrivateNodeHandle();
@@ -296,6 +437,21 @@ private:
 
     spinnaker_.setDesiredCamera((uint32_t)serial);
 
+    // Optionally keep the configuration in a UserSet on the camera, which connecting loads in one go while the
+    // configuration stays the same.
+    std::string user_set;
+    pnh.param<std::string>("user_set", user_set, "");
+    if (!user_set.empty())
+    {
+      const char* ros_home = std::getenv("ROS_HOME");
+      const char* home = std::getenv("HOME");
+      const std::string ros_home_dir = ros_home ? std::string(ros_home) : std::string(home ? home : ".") + "/.ros";
+      const std::string default_hash_file = ros_home_dir + "/spinnaker_user_set_" + std::to_string(serial);
+      std::string user_set_hash_file;
+      pnh.param<std::string>("user_set_hash_file", user_set_hash_file, default_hash_file);
+      spinnaker_.setUserSet(user_set, user_set_hash_file);
+    }
+
     // Get GigE camera parameters:
     pnh.param<int>("packet_size", packet_size_, 1400);
     pnh.param<bool>("auto_packet_size", auto_packet_size_, true);
@@ -312,6 +468,16 @@ private:
     // Do not call the connectCb function until after we are done initializing.
     std::lock_guard<std::mutex> scopedLock(connect_mutex_);
 
+    reconfigures_ = 0;
+    reconfigures_coalesced_ = 0;
+    last_reconfigure_latency_ = 0.0;
+    max_reconfigure_latency_ = 0.0;
+    last_reconfigure_wait_ = 0.0;
+    config_pending_ = false;
+    pending_level_ = 0;
+    exposure_pending_ = false;
+    roi_pending_ = false;
+
     // Start up the dynamic_reconfigure service, note that this needs to stick around after this function ends
     srv_ = std::make_shared<dynamic_reconfigure::Server<spinnaker_camera_driver::SpinnakerConfig> >(pnh);
     dynamic_reconfigure::Server<spinnaker_camera_driver::SpinnakerConfig>::CallbackType f =
@@ -323,18 +489,140 @@ private:
     int queue_size;
     pnh.param<int>("queue_size", queue_size, 1);
 
+    // Ring between the grab thread and the publish thread
+    int frame_ring_size;
+    pnh.param<int>("frame_ring_size", frame_ring_size, 4);
+    std::string frame_ring_policy_str;
+    pnh.param<std::string>("frame_ring_policy", frame_ring_policy_str, "drop_oldest");
+    WFOVImageRing::DropPolicy frame_ring_policy = WFOVImageRing::DROP_OLDEST;
+    if (!WFOVImageRing::parsePolicy(frame_ring_policy_str, &frame_ring_policy))
+    {
+      NODELET_WARN("Unknown frame_ring_policy '%s', using drop_oldest.", frame_ring_policy_str.c_str());
+    }
+    frame_ring_.reset(new WFOVImageRing(std::max(frame_ring_size, 1), frame_ring_policy));
+
+    // Scheduling of the driver threads, applied by each thread when it starts
+    pnh.param<std::vector<int> >("acquisition_thread_cpus", acquisition_thread_cpus_, std::vector<int>());
+    pnh.param<int>("acquisition_thread_priority", acquisition_thread_priority_, 0);
+    pnh.param<std::vector<int> >("diagnostics_thread_cpus", diagnostics_thread_cpus_, std::vector<int>());
+    bool lock_memory;
+    pnh.param<bool>("lock_memory", lock_memory, false);
+    memory_locked_ = false;
+    if (lock_memory)
+    {
+      std::string error;
+      memory_locked_ = lockProcessMemory(&error);
+      if (memory_locked_)
+        NODELET_INFO("Locked process memory.");
+      else
+        NODELET_WARN("Could not lock process memory, continuing without: %s", error.c_str());
+    }
+
+    // Retry connecting with exponential backoff, or as soon as a camera arrives
+    pnh.param<double>("reconnect_backoff_min", reconnect_backoff_min_, 0.1);
+    pnh.param<double>("reconnect_backoff_max", reconnect_backoff_max_, 5.0);
+    reconnect_backoff_max_ = std::max(reconnect_backoff_max_, reconnect_backoff_min_);
+    reconnect_backoff_ = reconnect_backoff_min_;
+
+    // What to do with frames that arrive with missing packets
+    std::string incomplete_frame_policy;
+    pnh.param<std::string>("incomplete_frame_policy", incomplete_frame_policy, "drop");
+    if (incomplete_frame_policy != "drop" && incomplete_frame_policy != "republish")
+    {
+      NODELET_WARN("Unknown incomplete_frame_policy '%s', using drop.", incomplete_frame_policy.c_str());
+      incomplete_frame_policy = "drop";
+    }
+    republish_incomplete_ = incomplete_frame_policy == "republish";
+    pnh.param<int>("max_consecutive_incomplete", max_consecutive_incomplete_, 10);
+    consecutive_incomplete_ = 0;
+    // Free running, a camera that stops delivering without being reported removed is reconnected after this many
+    pnh.param<int>("max_consecutive_timeouts", max_consecutive_timeouts_, 5);
+    consecutive_timeouts_ = 0;
+    timeout_escalations_ = 0;
+    grab_timeouts_ = 0;
+    incomplete_frames_ = 0;
+    republished_frames_ = 0;
+    incomplete_recoveries_ = 0;
+    incomplete_escalations_ = 0;
+
+    // Whether to stop acquiring while no one is subscribed, the camera stays connected and configured
+    pnh.param<bool>("pause_without_subscribers", pause_without_subscribers_, false);
+    has_subscribers_ = false;
+    acquisition_paused_ = false;
+
+    frames_grabbed_ = 0;
+    bytes_copied_ = 0;
+    acquisition_cpu_seconds_ = 0.0;
+    frames_published_ = 0;
+    publish_cpu_seconds_ = 0.0;
+    status_frames_grabbed_ = 0;
+    status_bytes_copied_ = 0;
+    status_acquisition_cpu_seconds_ = 0.0;
+    status_frames_published_ = 0;
+    status_publish_cpu_seconds_ = 0.0;
+
+    // Recycle images once subscribers release them, so streaming does not allocate a new image every frame
+    int message_pool_size;
+    pnh.param<int>("message_pool_size", message_pool_size, 8);
+    image_pool_.reset(new MessagePool<wfov_camera_msgs::WFOVImage>(std::max(message_pool_size, 0)));
+
+    // "ros" stamps frames with the time they were received, "camera" maps the camera's clock onto ROS time
+    pnh.param<std::string>("time_stamp_mode", time_stamp_mode_, "ros");
+    time_stamp_latch_period_ = 0.0;
+    if (time_stamp_mode_ == "camera")
+    {
+      int time_stamp_window;
+      pnh.param<int>("time_stamp_window", time_stamp_window, 100);
+      // Seconds between latching the camera clock to anchor the mapping, 0 to rely on the receive times alone
+      pnh.param<double>("time_stamp_latch_period", time_stamp_latch_period_, 1.0);
+      // Readout and transport latency to take off the receive times while there is no anchor
+      double time_stamp_latency;
+      pnh.param<double>("time_stamp_latency", time_stamp_latency, 0.0);
+      timestamp_estimator_.reset(new TimestampEstimator(std::max(time_stamp_window, 1), time_stamp_latency));
+    }
+    else if (time_stamp_mode_ != "ros")
+    {
+      NODELET_WARN("Unknown time_stamp_mode '%s', using ros.", time_stamp_mode_.c_str());
+      time_stamp_mode_ = "ros";
+    }
+
     // Start the camera info manager and attempt to load any configurations
     std::stringstream cinfo_name;
     cinfo_name << serial;
     cinfo_.reset(new camera_info_manager::CameraInfoManager(nh, cinfo_name.str(), camera_info_url));
+    updateCameraInfo();
 
     // Publish topics using ImageTransport through camera_info_manager (gives cool things like compression)
     it_.reset(new image_transport::ImageTransport(nh));
     image_transport::SubscriberStatusCallback cb = boost::bind(&SpinnakerCameraNodelet::connectCb, this);
     it_pub_ = it_->advertiseCamera("image_raw", queue_size, cb, cb);
 
+    // Optionally publish what image_proc/debayer would, without a separate nodelet copying every raw frame
+    bool debayer;
+    pnh.param<bool>("debayer", debayer, false);
+    if (debayer)
+    {
+      std::string debayer_algorithm_str;
+      pnh.param<std::string>("debayer_algorithm", debayer_algorithm_str, "bilinear");
+      Debayer::Algorithm debayer_algorithm = Debayer::BILINEAR;
+      if (!Debayer::parseAlgorithm(debayer_algorithm_str, &debayer_algorithm))
+      {
+        NODELET_WARN("Unknown debayer_algorithm '%s', using bilinear.", debayer_algorithm_str.c_str());
+      }
+      std::string debayer_color_order;
+      pnh.param<std::string>("debayer_color_order", debayer_color_order, "bgr");
+      debayer_.reset(new Debayer(debayer_algorithm, debayer_color_order == "rgb"));
+      debayer_pool_.reset(new MessagePool<sensor_msgs::Image>(2 * std::max(message_pool_size, 0)));
+      debayered_frames_ = 0;
+      debayer_seconds_ = 0.0;
+
+      it_pub_color_ = it_->advertise("image_color", queue_size, cb, cb);
+      it_pub_mono_ = it_->advertise("image_mono", queue_size, cb, cb);
+    }
+
     // Set up diagnostics
     updater_.setHardwareID("spinnaker_camera " + cinfo_name.str());
+    updater_.add("Driver Status", this, &SpinnakerCameraNodelet::driverStatus);
 
     // Set up a diagnosed publisher
     double desired_freq;
@@ -367,6 +655,9 @@ private:
         new ros::Publisher(nh.advertise<diagnostic_msgs::DiagnosticArray>(
             "/diagnostics", 1, diag_cb, diag_cb)));
 
+    // Latched, so that tools started later still learn what the connected camera supports
+    capabilities_pub_ = nh.advertise<diagnostic_msgs::DiagnosticStatus>("capabilities", 1, true);
+
     diag_man = std::unique_ptr<DiagnosticsManager>(new DiagnosticsManager(
         frame_id_, std::to_string(spinnaker_.getSerial()), diagnostics_pub_));
     diag_man->addDiagnostic("DeviceTemperature", true, std::make_pair(0.0f, 90.0f), -10.0f, 95.0f);
@@ -375,6 +666,17 @@ private:
     diag_man->addDiagnostic("PowerSupplyCurrent", true, std::make_pair(0.4f, 0.6f), 0.3f, 1.0f);
     diag_man->addDiagnostic<int>("DeviceUptime");
     diag_man->addDiagnostic<int>("U3VMessageChannelID");
+    diag_man->addStreamDiagnostic("StreamBufferUnderrunCount");
+    diag_man->addStreamDiagnostic("StreamDroppedFrameCount");
+    diag_man->addStreamDiagnostic("StreamLostFrameCount");
+    diag_man->addStreamDiagnostic("StreamFailedBufferCount");
+
+    // Connect and configure right away rather than on the first subscriber, so that cameras brought up together
+    // connect in parallel and the first frame is ready sooner
+    bool connect_on_start;
+    pnh.param<bool>("connect_on_start", connect_on_start, false);
+    if (connect_on_start)
+      startThreads();
   }
 
   /**
@@ -407,8 +709,153 @@ private:
     return 0;
   }
 
+  /*!
+  * \brief Applies CPU affinity and real-time priority to the calling thread.
+  *
+  * Failures, e.g. for lack of permissions, are logged and the thread carries on with whatever it got.
+  */
+  void configureCurrentThread(const std::string& thread_name, const std::vector<int>& cpus, const int priority)
+  {
+    std::string error;
+    if (!setCurrentThreadAffinity(cpus, &error))
+      NODELET_WARN("Could not set the CPU affinity of the %s thread: %s", thread_name.c_str(), error.c_str());
+    if (!setCurrentThreadRealtime(priority, &error))
+      NODELET_WARN("Could not run the %s thread under SCHED_FIFO: %s", thread_name.c_str(), error.c_str());
+
+    const std::string scheduling = describeCurrentThreadScheduling();
+    NODELET_INFO("The %s thread runs with %s.", thread_name.c_str(), scheduling.c_str());
+
+    std::lock_guard<std::mutex> scopedLock(thread_scheduling_mutex_);
+    thread_scheduling_[thread_name] = scheduling;
+  }
+
+  /// Logs how long each stage of connecting took and keeps the times for the driver status.
+  void reportConnectTimes(const SpinnakerCamera::StageTimes& connect_times)
+  {
+    std::ostringstream summary;
+    double total = 0.0;
+    for (const std::pair<std::string, double>& stage : connect_times)
+    {
+      summary << (&stage == &connect_times.front() ? "" : ", ") << stage.first << " "
+              << std::fixed << std::setprecision(3) << stage.second << " s";
+      total += stage.second;
+    }
+    NODELET_INFO("Connected to camera %u in %.3f s (%s).", spinnaker_.getSerial(), total, summary.str().c_str());
+
+    std::lock_guard<std::mutex> scopedLock(connect_times_mutex_);
+    connect_times_ = connect_times;
+  }
+
+  /// Publishes what the features the driver uses supported when the camera was last connected.
+  void publishCapabilities()
+  {
+    diagnostic_msgs::DiagnosticStatus status;
+    status.level = diagnostic_msgs::DiagnosticStatus::OK;
+    status.name = "Spinnaker " + std::to_string(spinnaker_.getSerial()) + " capabilities";
+    status.hardware_id = std::to_string(spinnaker_.getSerial());
+    status.message = "Probed at connect";
+
+    for (const std::pair<std::string, NodeCache::Capability>& feature : spinnaker_.getCapabilities())
+    {
+      const NodeCache::Capability& capability = feature.second;
+      std::ostringstream value;
+      if (!capability.implemented)
+        value << "not implemented";
+      else
+      {
+        switch (capability.type)
+        {
+          case Spinnaker::GenApi::intfIFloat:
+            value << "float";
+            break;
+          case Spinnaker::GenApi::intfIInteger:
+            value << "int";
+            break;
+          case Spinnaker::GenApi::intfIBoolean:
+            value << "bool";
+            break;
+          case Spinnaker::GenApi::intfIEnumeration:
+            value << "enum";
+            break;
+          case Spinnaker::GenApi::intfICommand:
+            value << "command";
+            break;
+          default:
+            value << "other";
+            break;
+        }
+        value << (!capability.available ? " NA" : capability.writable ? " RW" : " RO");
+        if (capability.has_range)
+          value << " [" << capability.min << ", " << capability.max << "]";
+        for (const std::string& entry : capability.entries)
+          value << (&entry == &capability.entries.front() ? " " : ",") << entry;
+      }
+
+      diagnostic_msgs::KeyValue key_value;
+      key_value.key = feature.first;
+      key_value.value = value.str();
+      status.values.push_back(key_value);
+    }
+    capabilities_pub_.publish(status);
+  }
+
+  /// Latches the camera clock and anchors the mapping of frame timestamps onto ROS time to it.
+  void anchorTimestamps()
+  {
+    last_latch_ = ros::WallTime::now();
+    try
+    {
+      uint64_t camera_stamp = 0;
+      ros::Time host_before;
+      ros::Time host_after;
+      if (spinnaker_.latchTimestamp(&camera_stamp, &host_before, &host_after))
+        timestamp_estimator_->anchor(camera_stamp, host_before, host_after);
+      else
+        NODELET_WARN_ONCE("The camera has no timestamp latch, time stamps are late by the receive latency less "
+                          "time_stamp_latency.");
+    }
+    catch (const std::runtime_error& e)
+    {
+      NODELET_WARN("%s", e.what());
+    }
+  }
+
+  /// Notes when the camera stopped delivering, for the recovery time statistics.
+  void cameraLost()
+  {
+    std::lock_guard<std::mutex> scopedLock(connect_times_mutex_);
+    if (lost_time_ == 0.0)
+      lost_time_ = ros::WallTime::now().toSec();
+  }
+
+  /*!
+  * \brief Waits before the next attempt to connect, doubling the wait each time up to reconnect_backoff_max_.
+  *
+  * Returns early when a device arrives, which is usually the camera coming back.
+  * \param arrivals_seen Device arrivals already seen before the failed attempt.
+  */
+  void waitForReconnect(const uint64_t arrivals_seen)
+  {
+    std::shared_ptr<SpinnakerSystem> system = SpinnakerSystem::instance();
+    const ros::WallTime deadline = ros::WallTime::now() + ros::WallDuration(reconnect_backoff_.load());
+    while (!boost::this_thread::interruption_requested() && ros::WallTime::now() < deadline)
+    {
+      // Wait in short slices so that shutting down is not held up
+      const double remaining = (deadline - ros::WallTime::now()).toSec();
+      const std::chrono::milliseconds slice(static_cast<int64_t>(1e3 * std::min(std::max(remaining, 0.0), 0.1)) + 1);
+      if (system->waitForArrival(arrivals_seen, slice))
+      {
+        NODELET_INFO("A camera arrived, reconnecting.");
+        break;
+      }
+    }
+    reconnect_backoff_ = std::min(2.0 * reconnect_backoff_.load(), reconnect_backoff_max_);
+  }
+
   void diagPoll()
   {
+    configureCurrentThread("diagnostics", diagnostics_thread_cpus_, 0);
+
     while (!boost::this_thread::interruption_requested())  // Block until we need
                                                            // to stop this
                                                            // thread.
@@ -418,15 +865,17 @@ private:
   }
 
   /*!
-  * \brief Function for the boost::thread to grabImages and publish them.
+  * \brief Function for the boost::thread to grabImages and queue them for publishing.
   *
-  * This function continues until the thread is interupted.  Responsible for getting sensor_msgs::Image and publishing
-  * them.
+  * This function continues until the thread is interupted.  Responsible for getting sensor_msgs::Image and pushing
+  * them into the frame ring drained by publishPoll.
   */
   void devicePoll()
   {
     ROS_INFO_ONCE("devicePoll");
 
+    configureCurrentThread("acquisition", acquisition_thread_cpus_, acquisition_thread_priority_);
+
     enum State
     {
       NONE,
@@ -501,23 +950,59 @@ private:
 
           break;
         case DISCONNECTED:
+        {
+          // Arrivals from here on may be the camera coming back, so a failed attempt retries on them
+          const uint64_t arrivals_seen = SpinnakerSystem::instance()->arrivals();
+
           // Try connecting to the camera
           try
           {
             NODELET_DEBUG("Connecting to camera.");
 
-            spinnaker_.connect();
-
-            NODELET_DEBUG("Connected to camera.");
-
-            // Set last configuration, forcing the reconfigure level to stop
-            spinnaker_.setNewConfiguration(config_, SpinnakerCamera::LEVEL_RECONFIGURE_STOP);
-
-            // Set the timeout for grabbing images.
+            {
+              // Other cameras in the process connect at the same time, up to the number of connect slots
+              const ros::WallTime wait_start = ros::WallTime::now();
+              SpinnakerSystem::ConnectSlot connect_slot(SpinnakerSystem::instance());
+              const ros::WallTime connect_start = ros::WallTime::now();
+
+              spinnaker_.connect();
+
+              NODELET_DEBUG("Connected to camera.");
+
+              // Set last configuration, forcing the reconfigure level to stop
+              const ros::WallTime configure_start = ros::WallTime::now();
+              const spinnaker_camera_driver::SpinnakerConfig config = takeConfiguration();
+              spinnaker_.setNewConfiguration(config, SpinnakerCamera::LEVEL_RECONFIGURE_STOP);
+              configurationApplied(config);
+
+              SpinnakerCamera::StageTimes connect_times = spinnaker_.getConnectTimes();
+              connect_times.insert(connect_times.begin(),
+                                   std::make_pair("slot wait", (connect_start - wait_start).toSec()));
+              connect_times.push_back(std::make_pair("configure", (ros::WallTime::now() - configure_start).toSec()));
+              reportConnectTimes(connect_times);
+            }
+            connected_time_ = ros::WallTime::now();
+            first_frame_pending_ = true;
+            reconnect_backoff_ = reconnect_backoff_min_;
+            consecutive_incomplete_ = 0;
+            consecutive_timeouts_ = 0;
+            last_good_frame_.reset();
+            removals_seen_ = SpinnakerSystem::instance()->removals(spinnaker_.getSerial());
+
+            // The camera clock may have restarted along with the camera
+            if (timestamp_estimator_)
+              timestamp_estimator_->reset();
+            last_latch_ = ros::WallTime();
+
+            // The full resolution fallback in the CameraInfo needs the connected camera
+            updateCameraInfo();
+            publishCapabilities();
+
+            // Set the timeout for grabbing images, 0 adapts it to the frame rate and trigger mode.
             try
             {
               double timeout;
-              getMTPrivateNodeHandle().param("timeout", timeout, 1.0);
+              getMTPrivateNodeHandle().param("timeout", timeout, 0.0);
 
               NODELET_DEBUG_ONCE("Setting timeout to: %f.", timeout);
               spinnaker_.setTimeout(timeout);
@@ -542,16 +1027,32 @@ private:
           }
           catch (const std::runtime_error& e)
           {
-            if (state_changed)
-            {
+            if (reconnect_backoff_ == reconnect_backoff_min_)
               NODELET_ERROR("Failed to connect with error: %s", e.what());
-              ros::Duration(1.0).sleep();  // sleep for one second each time
-            }
+            else
+              NODELET_DEBUG("Failed to connect with error: %s", e.what());
+            waitForReconnect(arrivals_seen);
             state = ERROR;
           }
 
           break;
+        }
         case CONNECTED:
+          applyPendingConfiguration();
+          if (pause_without_subscribers_ && !has_subscribers_)
+          {
+            // Leave the camera configured but idle until a subscriber shows up. Waiting on the condition variable
+            // is an interruption point, so this does not hold up shutting the thread down.
+            if (state_changed)
+              NODELET_INFO("No subscribers, acquisition paused.");
+            acquisition_paused_ = true;
+            boost::unique_lock<boost::mutex> subscriberLock(subscriber_mutex_);
+            subscriber_cv_.wait_for(subscriberLock, boost::chrono::milliseconds(100),
+                                    [this]() { return has_subscribers_.load(); });
+            break;
+          }
+          acquisition_paused_ = false;
+
           // Try starting the camera
           try
           {
@@ -574,65 +1075,162 @@ private:
 
           break;
         case STARTED:
+          if (pause_without_subscribers_ && !has_subscribers_)
+          {
+            try
+            {
+              NODELET_DEBUG("Stopping camera, nothing is subscribed.");
+              spinnaker_.stop();
+              state = CONNECTED;
+            }
+            catch (std::runtime_error& e)
+            {
+              NODELET_ERROR("Failed to stop with error: %s", e.what());
+              state = ERROR;
+            }
+            break;
+          }
+
+          // Between frames, so that the grab below never waits on a reconfigure
+          applyPendingConfiguration();
+          if (timestamp_estimator_ && time_stamp_latch_period_ > 0.0 &&
+              (ros::WallTime::now() - last_latch_).toSec() >= time_stamp_latch_period_)
+            anchorTimestamps();
+
           try
           {
-            wfov_camera_msgs::WFOVImagePtr wfov_image(new wfov_camera_msgs::WFOVImage);
+            wfov_camera_msgs::WFOVImagePtr wfov_image = image_pool_->acquire();
             // Get the image from the camera library
             NODELET_DEBUG_ONCE("Starting a new grab from camera with serial {%d}.", spinnaker_.getSerial());
-            spinnaker_.grabImage(&wfov_image->image, frame_id_);
+            const SpinnakerCamera::GrabResult grab_result = spinnaker_.grabImage(&wfov_image->image, frame_id_);
+            if (grab_result == SpinnakerCamera::GRAB_TIMEOUT)
+            {
+              // Between triggers this is expected, free running it is a fault once the camera is gone or stays silent
+              grab_timeouts_++;
+              if (SpinnakerSystem::instance()->removals(spinnaker_.getSerial()) != removals_seen_)
+              {
+                NODELET_ERROR("Camera %u was removed.", spinnaker_.getSerial());
+                cameraLost();
+                state = ERROR;
+              }
+              else if (!spinnaker_.isTriggered())
+              {
+                // The camera may hang or the stream stall without a removal event, or events may not be available
+                consecutive_timeouts_++;
+                if (max_consecutive_timeouts_ > 0 && consecutive_timeouts_ >= max_consecutive_timeouts_)
+                {
+                  NODELET_ERROR("No frame received in %d grabs in a row, reconnecting.", consecutive_timeouts_);
+                  consecutive_timeouts_ = 0;
+                  timeout_escalations_++;
+                  cameraLost();
+                  state = ERROR;
+                }
+                else
+                {
+                  NODELET_WARN_THROTTLE(1.0, "No frame received within %.3f s.", spinnaker_.getTimeout());
+                }
+              }
+              break;
+            }
+            else if (grab_result == SpinnakerCamera::GRAB_OK)
+            {
+              consecutive_timeouts_ = 0;
+              if (consecutive_incomplete_ > 0)
+              {
+                consecutive_incomplete_ = 0;
+                incomplete_recoveries_++;
+              }
+              if (republish_incomplete_)
+                last_good_frame_ = wfov_image;
+            }
+            else
+            {
+              // A few packets went missing, which is no reason to reconnect unless it keeps happening
+              consecutive_timeouts_ = 0;
+              incomplete_frames_++;
+              consecutive_incomplete_++;
+              if (max_consecutive_incomplete_ > 0 && consecutive_incomplete_ >= max_consecutive_incomplete_)
+              {
+                NODELET_ERROR("Received %d incomplete frames in a row, reconnecting.", consecutive_incomplete_);
+                consecutive_incomplete_ = 0;
+                incomplete_escalations_++;
+                cameraLost();
+                state = ERROR;
+                break;
+              }
+              NODELET_WARN_THROTTLE(1.0, "Received an incomplete frame, %s it.",
+                                    republish_incomplete_ && last_good_frame_ ? "republishing the last good frame for" :
+                                                                                "dropping");
+              if (!republish_incomplete_ || !last_good_frame_)
+                break;
+
+              // Stand in the pixels of the last good frame, keeping the time and frame ID of the incomplete one. The
+              // header of the last good frame is left alone, the synchronizer may be rewriting it on another thread,
+              // and the pixels go into the pooled buffer of the incomplete frame, which already has the capacity.
+              const sensor_msgs::Image& good = last_good_frame_->image;
+              sensor_msgs::Image& image = wfov_image->image;
+              image.height = good.height;
+              image.width = good.width;
+              image.encoding = good.encoding;
+              image.is_bigendian = good.is_bigendian;
+              image.step = good.step;
+              image.data.assign(good.data.begin(), good.data.end());
+              republished_frames_++;
+            }
 
             // Set other values
             wfov_image->header.frame_id = frame_id_;
+            wfov_image->header.seq = wfov_image->image.header.seq;
 
-            wfov_image->gain = gain_;
-            wfov_image->white_balance_blue = wb_blue_;
-            wfov_image->white_balance_red = wb_red_;
+            const ImageSettings settings = imageSettings();
+            wfov_image->gain = settings.gain;
+            wfov_image->white_balance_blue = settings.wb_blue;
+            wfov_image->white_balance_red = settings.wb_red;
 
             // wfov_image->temperature = spinnaker_.getCameraTemperature();
 
             ros::Time time = ros::Time::now();
+            if (timestamp_estimator_)
+              time = timestamp_estimator_->update(wfov_image->image.header.stamp.toNSec(), time);
             wfov_image->header.stamp = time;
             wfov_image->image.header.stamp = time;
 
-            // Set the CameraInfo message
-            ci_.reset(new sensor_msgs::CameraInfo(cinfo_->getCameraInfo()));
-            ci_->header.stamp = wfov_image->image.header.stamp;
-            ci_->header.frame_id = wfov_image->header.frame_id;
-            // The width/height in sensor_msgs/CameraInfo is full camera resolution in pixels,
-            // which is unchanged regardless of binning settings.
-            ci_->width = ci_->width == 0 ? spinnaker_.getWidthMax() * binning_x_ : ci_->width;
-            ci_->height = ci_->height == 0 ? spinnaker_.getHeightMax() * binning_y_ : ci_->height;
-            // The height, width, distortion model, and parameters are all filled in by camera info manager.
-            ci_->binning_x = binning_x_;
-            ci_->binning_y = binning_y_;
-            // NOTE: The ROI offset/size in Spinnaker driver is the values, given in binned image coordinates,
-            //       in sensor_msgs/CameraInfo, on the other hand, given in un-binned image coordinates.
-            ci_->roi.x_offset = roi_x_offset_ * binning_x_;
-            ci_->roi.y_offset = roi_y_offset_ * binning_y_;
-            ci_->roi.height = roi_height_ * binning_y_;
-            ci_->roi.width = roi_width_ * binning_x_;
-            ci_->roi.do_rectify = do_rectify_;
-
-            wfov_image->info = *ci_;
-
-            // Publish the full message
-            pub_->publish(wfov_image);
-
-            // Publish the message using standard image transport
-            if (it_pub_.getNumSubscribers() > 0)
+            if (first_frame_pending_)
             {
-              sensor_msgs::ImagePtr image(new sensor_msgs::Image(wfov_image->image));
-              it_pub_.publish(image, ci_);
+              first_frame_pending_ = false;
+              const ros::WallTime now = ros::WallTime::now();
+              const double since_connect = (now - connected_time_).toSec();
+              std::lock_guard<std::mutex> scopedLock(connect_times_mutex_);
+              if (lost_time_ > 0.0)
+              {
+                const double recovery = now.toSec() - lost_time_;
+                NODELET_INFO("Recovered %.3f s after losing the camera.", recovery);
+                lost_time_ = 0.0;
+                recoveries_++;
+                last_recovery_ = recovery;
+                max_recovery_ = std::max(max_recovery_, recovery);
+                total_recovery_ += recovery;
+              }
+              else if (time_to_first_frame_ == 0.0)
+              {
+                time_to_first_frame_ = (now - init_time_).toSec();
+                NODELET_INFO("First frame %.3f s after connecting, %.3f s after loading the nodelet.", since_connect,
+                             time_to_first_frame_);
+              }
             }
-          }
-          catch (CameraTimeoutException& e)
-          {
-            NODELET_WARN("%s", e.what());
-          }
 
+            // Hand the frame over to the publish thread so slow subscribers never delay the next grab
+            frame_ring_->push(wfov_image);
+
+            // The pixels were copied once, out of the stream buffer or from the last good frame
+            bytes_copied_ += wfov_image->image.data.size();
+            acquisition_cpu_seconds_ = currentThreadCpuTime();
+            ++frames_grabbed_;
+          }
           catch (std::runtime_error& e)
           {
             NODELET_ERROR("%s", e.what());
+            cameraLost();
             state = ERROR;
           }
 
@@ -640,56 +1238,473 @@ private:
         default:
           NODELET_ERROR("Unknown camera state %d!", state);
       }
+    }
+    NODELET_DEBUG_ONCE("Leaving thread.");
+  }
+
+  /*!
+  * \brief Function for the boost::thread to publish the images queued up by devicePoll.
+  *
+  * This function continues until the thread is interupted.  Responsible for filling in the CameraInfo and publishing
+  * both the WFOVImage and the image_transport topics, as well as updating the diagnostics.
+  */
+  void publishPoll()
+  {
+    while (!boost::this_thread::interruption_requested())  // Block until we need to stop this thread.
+    {
+      wfov_camera_msgs::WFOVImagePtr wfov_image;
+      if (frame_ring_->waitPop(&wfov_image, std::chrono::milliseconds(100)))
+      {
+        const double cpu_seconds = currentThreadCpuTime();
+        if (frame_sink_)
+          frame_sink_(wfov_image);
+        else
+          publishImage(wfov_image);
+        addSeconds(&publish_cpu_seconds_, currentThreadCpuTime() - cpu_seconds);
+        ++frames_published_;
+      }
+
+      checkCalibration();
 
       // Update diagnostics
       updater_.update();
     }
-    NODELET_DEBUG_ONCE("Leaving thread.");
+    NODELET_DEBUG_ONCE("Leaving publish thread.");
   }
 
-  void gainWBCallback(const image_exposure_msgs::ExposureSequence& msg)
+  /// Copies the image settings, to read them or to modify them and pass them to setImageSettings.
+  ImageSettings imageSettings()
   {
+    std::lock_guard<std::mutex> scopedLock(camera_info_mutex_);
+    return image_settings_;
+  }
+
+  /// Replaces the image settings and rebuilds the CameraInfo from them.
+  void setImageSettings(const ImageSettings& settings)
+  {
+    std::lock_guard<std::mutex> scopedLock(camera_info_mutex_);
+    image_settings_ = settings;
+    buildCameraInfo();
+  }
+
+  /// Rebuilds the CameraInfo, e.g. for a new calibration or once the full resolution is known.
+  void updateCameraInfo()
+  {
+    std::lock_guard<std::mutex> scopedLock(camera_info_mutex_);
+    buildCameraInfo();
+  }
+
+  /*!
+  * \brief Rebuilds the CameraInfo shared by all frames from the calibration and image_settings_.
+  *
+  * Called whenever the calibration, binning or ROI may have changed, so that publishing a frame only has to stamp it.
+  * Must be called with camera_info_mutex_ held, which keeps a rebuild from an older snapshot from replacing a newer
+  * one. The result is swapped in atomically, so publishing never waits for a rebuild.
+  */
+  void buildCameraInfo()
+  {
+    const ImageSettings& settings = image_settings_;
+    const sensor_msgs::CameraInfo calibration = cinfo_->getCameraInfo();
+    sensor_msgs::CameraInfoPtr ci(new sensor_msgs::CameraInfo(calibration));
+
+    // The width/height in sensor_msgs/CameraInfo is full camera resolution in pixels,
+    // which is unchanged regardless of binning settings.
+    ci->width = ci->width == 0 ? spinnaker_.getWidthMax() * settings.binning_x : ci->width;
+    ci->height = ci->height == 0 ? spinnaker_.getHeightMax() * settings.binning_y : ci->height;
+    // The height, width, distortion model, and parameters are all filled in by camera info manager.
+    ci->binning_x = settings.binning_x;
+    ci->binning_y = settings.binning_y;
+    // NOTE: The ROI offset/size in Spinnaker driver is the values, given in binned image coordinates,
+    //       in sensor_msgs/CameraInfo, on the other hand, given in un-binned image coordinates.
+    ci->roi.x_offset = settings.roi_x_offset * settings.binning_x;
+    ci->roi.y_offset = settings.roi_y_offset * settings.binning_y;
+    ci->roi.height = settings.roi_height * settings.binning_y;
+    ci->roi.width = settings.roi_width * settings.binning_x;
+    ci->roi.do_rectify = settings.do_rectify;
+
+    calibration_ = calibration;
+    boost::atomic_store(&camera_info_, sensor_msgs::CameraInfoConstPtr(ci));
+  }
+
+  sensor_msgs::CameraInfoConstPtr cameraInfo() const
+  {
+    return boost::atomic_load(&camera_info_);
+  }
+
+  /*!
+  * \brief Rebuilds the CameraInfo if the calibration was changed, e.g. through the set_camera_info service.
+  *
+  * CameraInfoManager has no notification for this, so it is polled at a low rate instead.
+  */
+  void checkCalibration()
+  {
+    const ros::WallTime now = ros::WallTime::now();
+    if ((now - calibration_checked_).toSec() < 1.0)
+      return;
+    calibration_checked_ = now;
+
+    const sensor_msgs::CameraInfo calibration = cinfo_->getCameraInfo();
+    bool changed;
+    {
+      std::lock_guard<std::mutex> scopedLock(camera_info_mutex_);
+      changed = calibration.width != calibration_.width || calibration.height != calibration_.height ||
+                calibration.distortion_model != calibration_.distortion_model || calibration.D != calibration_.D ||
+                calibration.K != calibration_.K || calibration.R != calibration_.R || calibration.P != calibration_.P;
+    }
+    if (changed)
+    {
+      NODELET_INFO("Camera calibration changed.");
+      updateCameraInfo();
+    }
+  }
+
+  /// Copies the CameraInfo, which is the same for every frame but for the header, and stamps it for wfov_image.
+  static void stampCameraInfo(const sensor_msgs::CameraInfo& camera_info, const wfov_camera_msgs::WFOVImage& wfov_image,
+                              sensor_msgs::CameraInfo* info)
+  {
+    *info = camera_info;
+    info->header.stamp = wfov_image.image.header.stamp;
+    info->header.frame_id = wfov_image.header.frame_id;
+  }
+
+  void publishImage(const wfov_camera_msgs::WFOVImagePtr& wfov_image)
+  {
+    // Only build what someone is going to receive
+    const bool publish_wfov = pub_->getPublisher().getNumSubscribers() > 0;
+    const bool publish_raw = it_pub_.getNumSubscribers() > 0;
+
+    if (publish_wfov)
+    {
+      // The WFOVImage holds the CameraInfo by value, so it gets a stamped copy of the ready made one
+      stampCameraInfo(*cameraInfo(), *wfov_image, &wfov_image->info);
+
+      // Publish the full message
+      pub_->publish(wfov_image);
+    }
+    else
+    {
+      // Keep the frequency and time stamp diagnostics of the publisher going
+      pub_->tick(wfov_image->header.stamp);
+    }
+
+    // Publish the message using standard image transport. The image pointer shares ownership of the WFOVImage it
+    // lives in, so intra-process subscribers receive the grabbed frame without a copy. The info does too when the
+    // WFOVImage was published, otherwise it is the only copy of the CameraInfo made for this frame.
+    if (publish_raw)
+    {
+      sensor_msgs::ImagePtr image(wfov_image, &wfov_image->image);
+      sensor_msgs::CameraInfoPtr info;
+      if (publish_wfov)
+      {
+        info = sensor_msgs::CameraInfoPtr(wfov_image, &wfov_image->info);
+      }
+      else
+      {
+        info.reset(new sensor_msgs::CameraInfo());
+        stampCameraInfo(*cameraInfo(), *wfov_image, info.get());
+      }
+      it_pub_.publish(image, info);
+    }
+
+    if (debayer_)
+    {
+      publishDebayered(wfov_image);
+    }
+  }
+
+  /*!
+  * \brief Publishes image_color and image_mono the way image_proc/debayer does, for whichever has subscribers.
+  *
+  * Bayer images are demosaiced, color images are converted to mono and images that already have the right format
+  * are published as they are, sharing the raw frame.
+  */
+  void publishDebayered(const wfov_camera_msgs::WFOVImagePtr& wfov_image)
+  {
+    const bool publish_color = it_pub_color_.getNumSubscribers() > 0;
+    const bool publish_mono = it_pub_mono_.getNumSubscribers() > 0;
+    if (!publish_color && !publish_mono)
+      return;
+
+    const sensor_msgs::Image& raw = wfov_image->image;
+    const sensor_msgs::ImagePtr raw_image(wfov_image, &wfov_image->image);
+    const ros::WallTime start = ros::WallTime::now();
+    bool converted = false;  // Pass-through frames are not counted as debayered
+
     try
     {
-      NODELET_DEBUG_ONCE("Gain callback:  Setting gain to %f and white balances to %u, %u", msg.gain,
-                         msg.white_balance_blue, msg.white_balance_red);
-      gain_ = msg.gain;
+      if (publish_color)
+      {
+        if (sensor_msgs::image_encodings::isBayer(raw.encoding))
+        {
+          sensor_msgs::ImagePtr color = debayer_pool_->acquire();
+          converted = debayer_->toColor(raw, color.get());
+          it_pub_color_.publish(color);
+        }
+        else
+        {
+          it_pub_color_.publish(raw_image);
+        }
+      }
+
+      if (publish_mono)
+      {
+        if (sensor_msgs::image_encodings::isMono(raw.encoding))
+        {
+          it_pub_mono_.publish(raw_image);
+        }
+        else
+        {
+          sensor_msgs::ImagePtr mono = debayer_pool_->acquire();
+          if (debayer_->toMono(raw, mono.get()))
+          {
+            converted = true;
+            it_pub_mono_.publish(mono);
+          }
+          else
+            NODELET_WARN_ONCE("Cannot convert %s images to mono.", raw.encoding.c_str());
+        }
+      }
+    }
+    catch (const std::exception& e)
+    {
+      NODELET_ERROR("Debayering failed with error: %s", e.what());
+    }
+
+    if (!converted)
+      return;
+    debayered_frames_++;
+    addSeconds(&debayer_seconds_, (ros::WallTime::now() - start).toSec());
+  }
+
+  /// Adds to a time total that several threads may update, std::atomic<double> has no fetch_add before C++20.
+  static void addSeconds(std::atomic<double>* total, const double seconds)
+  {
+    double expected = total->load();
+    while (!total->compare_exchange_weak(expected, expected + seconds))
+    {
+    }
+  }
+
+  /*!
+  * \brief Reports the state of the driver itself, as opposed to the camera, to the diagnostic updater.
+  */
+  void driverStatus(diagnostic_updater::DiagnosticStatusWrapper& stat)
+  {
+    stat.summary(diagnostic_msgs::DiagnosticStatus::OK, "OK");
+
+    stat.add("Frame ring capacity", frame_ring_->capacity());
+    stat.add("Frame ring occupancy", frame_ring_->size());
+    stat.add("Frame ring peak occupancy", frame_ring_->peakOccupancy());
+    stat.add("Frame ring policy", frame_ring_->policy() == WFOVImageRing::DROP_OLDEST ? "drop_oldest" : "drop_newest");
+    stat.add("Frames queued", frame_ring_->pushed());
+    stat.add("Frames dropped", frame_ring_->dropped());
+    if (frame_ring_->dropped() > 0)
+      stat.mergeSummary(diagnostic_msgs::DiagnosticStatus::WARN, "Frames dropped between grab and publish");
+
+    // CPU time and bytes copied per frame since the last report. The counters are updated concurrently, so read each
+    // one once.
+    const uint64_t frames_grabbed = frames_grabbed_;
+    const uint64_t bytes_copied = bytes_copied_;
+    const double acquisition_cpu_seconds = acquisition_cpu_seconds_;
+    const uint64_t frames_published = frames_published_;
+    const double publish_cpu_seconds = publish_cpu_seconds_;
+    if (frames_grabbed > status_frames_grabbed_)
+    {
+      stat.add("Acquisition CPU per frame (ms)", 1e3 * (acquisition_cpu_seconds - status_acquisition_cpu_seconds_) /
+                                                     (frames_grabbed - status_frames_grabbed_));
+      stat.add("Bytes copied per frame",
+               (bytes_copied - status_bytes_copied_) / (frames_grabbed - status_frames_grabbed_));
+    }
+    stat.add("Bytes copied", bytes_copied);
+    if (frames_published > status_frames_published_)
+    {
+      stat.add("Publish CPU per frame (ms)", 1e3 * (publish_cpu_seconds - status_publish_cpu_seconds_) /
+                                                 (frames_published - status_frames_published_));
+    }
+    status_frames_grabbed_ = frames_grabbed;
+    status_bytes_copied_ = bytes_copied;
+    status_acquisition_cpu_seconds_ = acquisition_cpu_seconds;
+    status_frames_published_ = frames_published;
+    status_publish_cpu_seconds_ = publish_cpu_seconds;
+
+    {
+      std::lock_guard<std::mutex> scopedLock(connect_times_mutex_);
+      for (const std::pair<std::string, double>& stage : connect_times_)
+        stat.add("Connect " + stage.first + " (s)", stage.second);
+      if (time_to_first_frame_ > 0.0)
+        stat.add("Time to first frame (s)", time_to_first_frame_);
+
+      stat.add("Reconnect backoff (s)", reconnect_backoff_.load());
+      stat.add("Recoveries", recoveries_);
+      if (recoveries_ > 0)
+      {
+        stat.add("Last recovery time (s)", last_recovery_);
+        stat.add("Max recovery time (s)", max_recovery_);
+        stat.add("Mean recovery time (s)", total_recovery_ / recoveries_);
+      }
+      if (lost_time_ > 0.0)
+        stat.mergeSummary(diagnostic_msgs::DiagnosticStatus::WARN, "Camera lost, reconnecting");
+    }
+
+    stat.add("Grab timeout (s)", spinnaker_.getTimeout());
+    stat.add("Triggered", spinnaker_.isTriggered());
+    stat.add("Grab timeouts", grab_timeouts_.load());
+    stat.add("Reconnects after grab timeouts", timeout_escalations_.load());
+
+    stat.add("Reconfigures", reconfigures_.load());
+    stat.add("Reconfigures coalesced", reconfigures_coalesced_.load());
+    if (reconfigures_ > 0)
+    {
+      stat.add("Last reconfigure wait (ms)", 1e3 * last_reconfigure_wait_);
+      stat.add("Last reconfigure latency (ms)", 1e3 * last_reconfigure_latency_);
+      stat.add("Max reconfigure latency (ms)", 1e3 * max_reconfigure_latency_);
+    }
+
+    const SpinnakerCamera::RoiStatistics roi_statistics = spinnaker_.getRoiStatistics();
+    stat.add("ROI updates", roi_statistics.updates);
+    if (roi_statistics.updates > 0)
+    {
+      stat.add("Last ROI update latency (ms)", 1e3 * roi_statistics.last_latency);
+      stat.add("Max ROI update latency (ms)", 1e3 * roi_statistics.max_latency);
+      stat.add("ROI updates restarting acquisition", roi_statistics.restarts);
+      stat.add("Frames lost to ROI updates (estimated)", roi_statistics.frames_lost);
+    }
+    if (roi_statistics.restarts > 0)
+      stat.add("Last ROI restart blackout (ms)", 1e3 * roi_statistics.last_blackout);
+
+    uint64_t node_lookups = 0;
+    uint64_t node_cache_hits = 0;
+    spinnaker_.getNodeCacheStatistics(&node_lookups, &node_cache_hits);
+    stat.add("Node map lookups", node_lookups);
+    stat.add("Node cache hits", node_cache_hits);
+
+    stat.add("Incomplete frame policy", republish_incomplete_ ? "republish" : "drop");
+    stat.add("Incomplete frames", incomplete_frames_.load());
+    stat.add("Republished frames", republished_frames_.load());
+    stat.add("Recoveries from incomplete frames", incomplete_recoveries_.load());
+    stat.add("Reconnects after incomplete frames", incomplete_escalations_.load());
+    if (incomplete_frames_ > 0)
+      stat.mergeSummary(diagnostic_msgs::DiagnosticStatus::WARN, "Incomplete frames received");
+
+    stat.add("Message pool size", image_pool_->capacity());
+    stat.add("Image pool hits", image_pool_->hits());
+    stat.add("Image pool misses", image_pool_->misses());
+
+    if (debayer_)
+    {
+      const uint64_t debayered_frames = debayered_frames_;
+      const double debayer_seconds = debayer_seconds_;
+      stat.add("Debayered frames", debayered_frames);
+      stat.add("Average debayer time (ms)", debayered_frames > 0 ? 1e3 * debayer_seconds / debayered_frames : 0.0);
+    }
+
+    stat.add("Pause without subscribers", pause_without_subscribers_);
+    stat.add("Acquisition paused", acquisition_paused_.load());
 
-      spinnaker_.setGain(static_cast<float>(gain_));
-      wb_blue_ = msg.white_balance_blue;
-      wb_red_ = msg.white_balance_red;
+    stat.add("Memory locked", memory_locked_);
+    {
+      std::lock_guard<std::mutex> scopedLock(thread_scheduling_mutex_);
+      for (const auto& thread : thread_scheduling_)
+        stat.add("Scheduling of the " + thread.first + " thread", thread.second);
+    }
+
+    stat.add("Time stamp mode", time_stamp_mode_);
+    if (timestamp_estimator_)
+    {
+      const TimestampEstimator::Statistics clock = timestamp_estimator_->statistics();
+      stat.add("Clock fit samples", clock.samples);
+      stat.add("Clock fit residual RMS (ms)", clock.residual_rms * 1e3);
+      stat.add("Clock fit residual max (ms)", clock.residual_max * 1e3);
+      stat.add("Clock drift (ppm)", clock.drift_ppm);
+      stat.add("Clock resets", clock.resets);
+      stat.add("Clock anchored", clock.anchored);
+      if (clock.anchored)
+      {
+        stat.add("Clock anchor uncertainty (ms)", clock.anchor_uncertainty * 1e3);
+        stat.add("Receive latency (ms)", clock.latency * 1e3);
+      }
+    }
+  }
+
+  /// Queues a gain and white balance for devicePoll to apply between frames, the latest one wins as in paramCallback.
+  void gainWBCallback(const image_exposure_msgs::ExposureSequence& msg)
+  {
+    NODELET_DEBUG_ONCE("Gain callback:  Setting gain to %f and white balances to %u, %u", msg.gain,
+                       msg.white_balance_blue, msg.white_balance_red);
+    std::lock_guard<std::mutex> scopedLock(config_mutex_);
+    if (exposure_pending_)
+      reconfigures_coalesced_++;
+    pending_exposure_ = msg;
+    exposure_pending_ = true;
+  }
 
-      // TODO(mhosmar):
-      // spinnaker_.setBRWhiteBalance(false, wb_blue_, wb_red_);
+  void applyExposure(const image_exposure_msgs::ExposureSequence& msg)
+  {
+    ImageSettings settings = imageSettings();
+    try
+    {
+      spinnaker_.setGain(static_cast<float>(msg.gain));
+      settings.gain = msg.gain;
     }
     catch (std::runtime_error& e)
     {
-      NODELET_ERROR("gainWBCallback failed with error: %s", e.what());
+      NODELET_ERROR("Setting the gain failed with error: %s", e.what());
     }
+    settings.wb_blue = msg.white_balance_blue;
+    settings.wb_red = msg.white_balance_red;
+    setImageSettings(settings);
+
+    // TODO(mhosmar):
+    // spinnaker_.setBRWhiteBalance(false, settings.wb_blue, settings.wb_red);
   }
 
+  /// Queues an ROI for devicePoll to apply between frames, the latest one wins as in paramCallback.
   void roiCallback(const sensor_msgs::RegionOfInterest::ConstPtr &msg)
   {
-    if ((msg->width + msg->height) > 0 &&
-        (static_cast<int>(msg->width) < spinnaker_.getWidthMax() ||
-         static_cast<int>(msg->height) < spinnaker_.getHeightMax()))
+    std::lock_guard<std::mutex> scopedLock(config_mutex_);
+    if (roi_pending_)
+      reconfigures_coalesced_++;
+    pending_roi_ = *msg;
+    roi_pending_ = true;
+  }
+
+  void applyRegionOfInterest(const sensor_msgs::RegionOfInterest& roi)
+  {
+    ImageSettings settings = imageSettings();
+    if ((roi.width + roi.height) > 0 &&
+        (static_cast<int>(roi.width) < spinnaker_.getWidthMax() ||
+         static_cast<int>(roi.height) < spinnaker_.getHeightMax()))
     {
-      roi_x_offset_ = msg->x_offset;
-      roi_y_offset_ = msg->y_offset;
-      roi_width_ = msg->width;
-      roi_height_ = msg->height;
-      do_rectify_ = true;
+      settings.roi_x_offset = roi.x_offset;
+      settings.roi_y_offset = roi.y_offset;
+      settings.roi_width = roi.width;
+      settings.roi_height = roi.height;
+      settings.do_rectify = true;
     }
     else
     {
       // Zeros mean the full resolution was captured.
-      roi_x_offset_ = 0;
-      roi_y_offset_ = 0;
-      roi_height_ = 0;
-      roi_width_ = 0;
-      do_rectify_ = false;  // Set to false if the whole image is captured.
+      settings.roi_x_offset = 0;
+      settings.roi_y_offset = 0;
+      settings.roi_height = 0;
+      settings.roi_width = 0;
+      settings.do_rectify = false;  // Set to false if the whole image is captured.
+    }
+    try
+    {
+      spinnaker_.setROI(settings.roi_x_offset, settings.roi_y_offset, settings.roi_width, settings.roi_height);
+      setImageSettings(settings);
+    }
+    catch (const std::runtime_error& e)
+    {
+      NODELET_ERROR("Setting the ROI failed with error: %s", e.what());
     }
-    spinnaker_.setROI(roi_x_offset_, roi_y_offset_, roi_width_, roi_height_);
+
+    const SpinnakerCamera::RoiStatistics roi_statistics = spinnaker_.getRoiStatistics();
+    NODELET_DEBUG("ROI update took %.3f ms, %lu of %lu updates restarted acquisition, %lu frames lost.",
+                  1e3 * roi_statistics.last_latency, static_cast<unsigned long>(roi_statistics.restarts),
+                  static_cast<unsigned long>(roi_statistics.updates),
+                  static_cast<unsigned long>(roi_statistics.frames_lost));
   }
 
   /* Class Fields */
@@ -703,8 +1718,11 @@ private:
   std::shared_ptr<camera_info_manager::CameraInfoManager> cinfo_;  ///< Needed to initialize and keep the
                                                                    /// CameraInfoManager in scope.
   image_transport::CameraPublisher it_pub_;                        ///< CameraInfoManager ROS publisher
+  image_transport::Publisher it_pub_color_;  ///< Demosaiced color images, only advertised when debayering.
+  image_transport::Publisher it_pub_mono_;   ///< Mono images, only advertised when debayering.
   std::shared_ptr<diagnostic_updater::DiagnosedPublisher<wfov_camera_msgs::WFOVImage> > pub_;  ///< Diagnosed
   std::shared_ptr<ros::Publisher> diagnostics_pub_;
+  ros::Publisher capabilities_pub_;  ///< Latched capabilities of the connected camera, see publishCapabilities.
   /// publisher, has to be
   /// a pointer because of
   /// constructor
@@ -714,31 +1732,109 @@ private:
 
   std::mutex connect_mutex_;
 
+  // Subscriber tracking, set by connectCb and acted on by grabThread_
+  bool pause_without_subscribers_;         ///< Whether to stop acquiring while nothing is subscribed.
+  std::atomic<bool> has_subscribers_;      ///< Whether any of the image topics has a subscriber.
+  std::atomic<bool> acquisition_paused_;   ///< Whether grabThread_ is currently waiting for a subscriber.
+  boost::mutex subscriber_mutex_;
+  boost::condition_variable subscriber_cv_;  ///< Wakes a paused grabThread_ when a subscriber appears.
+
   diagnostic_updater::Updater updater_;  ///< Handles publishing diagnostics messages.
   double min_freq_;
   double max_freq_;
 
   SpinnakerCamera spinnaker_;      ///< Instance of the SpinnakerCamera library, used to interface with the hardware.
-  sensor_msgs::CameraInfoPtr ci_;  ///< Camera Info message.
+  /// CameraInfo for the current configuration, without a header. Only accessed with boost::atomic_load/store.
+  sensor_msgs::CameraInfoConstPtr camera_info_;
+  sensor_msgs::CameraInfo calibration_;  ///< Calibration camera_info_ was built from.
+  std::mutex camera_info_mutex_;         ///< Guards image_settings_ and calibration_, and serializes rebuilds.
+  ros::WallTime calibration_checked_;            ///< When cinfo_ was last checked for a new calibration.
+
+  // Startup timing
+  ros::WallTime init_time_;                    ///< When onInit ran.
+  ros::WallTime connected_time_;               ///< When the camera was last connected and configured.
+  bool first_frame_pending_;                   ///< Whether no frame was grabbed since connecting.
+  std::mutex connect_times_mutex_;             ///< Guards the startup and recovery timing.
+  SpinnakerCamera::StageTimes connect_times_;  ///< How long each stage of the last connect took.
+  double time_to_first_frame_;                 ///< Seconds from onInit to the first frame, 0 until then.
+
+  // Reconnecting after the camera was lost
+  double reconnect_backoff_min_;           ///< Wait after the first failed attempt to connect, in seconds.
+  double reconnect_backoff_max_;           ///< Longest wait between attempts to connect, in seconds.
+  std::atomic<double> reconnect_backoff_;  ///< Wait after the next failed attempt to connect.
+  uint64_t removals_seen_;                 ///< Removals of this camera seen before it was last connected.
+  double lost_time_;                       ///< Wall time in seconds the camera was lost at, 0 while it delivers.
+  uint64_t recoveries_;                    ///< Times frames came in again after the camera was lost.
+  double last_recovery_;                   ///< Seconds from losing the camera to the next frame, the last time.
+  double max_recovery_;
+  double total_recovery_;
   std::string frame_id_;           ///< Frame id for the camera messages, defaults to 'camera'
-  std::shared_ptr<boost::thread> pubThread_;  ///< The thread that reads and publishes the images.
+  std::shared_ptr<boost::thread> grabThread_;  ///< The thread that reads the images from the camera.
+  std::shared_ptr<boost::thread> publishThread_;  ///< The thread that publishes the images read by grabThread_.
+
+  typedef FrameRing<wfov_camera_msgs::WFOVImagePtr> WFOVImageRing;
+  std::unique_ptr<WFOVImageRing> frame_ring_;  ///< Hands frames from grabThread_ to publishThread_.
+  FrameSink frame_sink_;  ///< Takes the frames instead of publishImage when set.
+
+  // Scheduling of the driver threads
+  std::vector<int> acquisition_thread_cpus_;  ///< CPUs grabThread_ is pinned to, empty for no pinning.
+  int acquisition_thread_priority_;           ///< SCHED_FIFO priority of grabThread_, 0 for the default policy.
+  std::vector<int> diagnostics_thread_cpus_;  ///< CPUs diagThread_ is pinned to, empty for no pinning.
+  bool memory_locked_;                        ///< Whether lock_memory was requested and succeeded.
+  std::mutex thread_scheduling_mutex_;
+  std::map<std::string, std::string> thread_scheduling_;  ///< Scheduling each thread actually got, by thread name.
+
+  std::unique_ptr<MessagePool<wfov_camera_msgs::WFOVImage> > image_pool_;  ///< Recycles the published images.
+
+  // Incomplete frames, only written by grabThread_
+  bool republish_incomplete_;       ///< Whether to stand in the last good frame for an incomplete one, else drop it.
+  int max_consecutive_incomplete_;  ///< Incomplete frames in a row before reconnecting, 0 to never reconnect.
+  int consecutive_incomplete_;
+  wfov_camera_msgs::WFOVImageConstPtr last_good_frame_;  ///< Only kept when republishing.
+  std::atomic<uint64_t> grab_timeouts_;  ///< Grabs that ended without a frame, e.g. while waiting for a trigger.
+  int max_consecutive_timeouts_;  ///< Free running grab timeouts in a row before reconnecting, 0 to never reconnect.
+  int consecutive_timeouts_;
+  std::atomic<uint64_t> timeout_escalations_;  ///< Reconnects because of too many grab timeouts in a row.
+
+  // Time spent applying dynamic_reconfigure changes to the camera, set by applyConfiguration
+  std::atomic<uint64_t> reconfigures_;
+  std::atomic<uint64_t> reconfigures_coalesced_;  ///< Configurations replaced by a later one before being applied.
+  std::atomic<double> last_reconfigure_latency_;
+  std::atomic<double> max_reconfigure_latency_;
+  std::atomic<double> last_reconfigure_wait_;  ///< Seconds the last queued configuration waited for devicePoll.
+  std::atomic<uint64_t> incomplete_frames_;
+  std::atomic<uint64_t> republished_frames_;
+  std::atomic<uint64_t> incomplete_recoveries_;   ///< Complete frames following incomplete ones.
+  std::atomic<uint64_t> incomplete_escalations_;  ///< Reconnects because of too many incomplete frames in a row.
+
+  // CPU and copy accounting, reported per frame by driverStatus
+  std::atomic<uint64_t> frames_grabbed_;          ///< Frames grabThread_ handed to the frame ring.
+  std::atomic<uint64_t> bytes_copied_;            ///< Pixel bytes grabThread_ copied into those frames.
+  std::atomic<double> acquisition_cpu_seconds_;   ///< CPU time grabThread_ had used after its last frame.
+  std::atomic<uint64_t> frames_published_;        ///< Frames publishThread_ took from the frame ring.
+  std::atomic<double> publish_cpu_seconds_;       ///< CPU time publishThread_ spent publishing those frames.
+  uint64_t status_frames_grabbed_;                ///< frames_grabbed_ at the last driverStatus.
+  uint64_t status_bytes_copied_;                  ///< bytes_copied_ at the last driverStatus.
+  double status_acquisition_cpu_seconds_;         ///< acquisition_cpu_seconds_ at the last driverStatus.
+  uint64_t status_frames_published_;              ///< frames_published_ at the last driverStatus.
+  double status_publish_cpu_seconds_;             ///< publish_cpu_seconds_ at the last driverStatus.
+
+  std::unique_ptr<Debayer> debayer_;  ///< Converts raw frames for image_color and image_mono, null if disabled.
+  std::unique_ptr<MessagePool<sensor_msgs::Image> > debayer_pool_;  ///< Recycles the converted images.
+  // Frames converted by debayer_, from publishThread_ or, when synchronized, another camera's publish thread.
+  std::atomic<uint64_t> debayered_frames_;
+  std::atomic<double> debayer_seconds_;  ///< Total time spent converting those frames.
+
+  std::string time_stamp_mode_;                              ///< How frames are stamped, "ros" or "camera".
+  std::unique_ptr<TimestampEstimator> timestamp_estimator_;  ///< Maps camera time to ROS time in "camera" mode.
+  double time_stamp_latch_period_;  ///< Seconds between anchoring timestamp_estimator_, 0 to never anchor it.
+  ros::WallTime last_latch_;        ///< When the camera clock was last latched, only used by grabThread_.
   std::shared_ptr<boost::thread> diagThread_;  ///< The thread that reads and publishes the diagnostics.
 
   std::unique_ptr<DiagnosticsManager> diag_man;
 
-  double gain_;
-  uint16_t wb_blue_;
-  uint16_t wb_red_;
-
-  // Parameters for cameraInfo
-  size_t binning_x_;     ///< Camera Info pixel binning along the image x axis.
-  size_t binning_y_;     ///< Camera Info pixel binning along the image y axis.
-  size_t roi_x_offset_;  ///< Camera Info ROI x offset
-  size_t roi_y_offset_;  ///< Camera Info ROI y offset
-  size_t roi_height_;    ///< Camera Info ROI height
-  size_t roi_width_;     ///< Camera Info ROI width
-  bool do_rectify_;  ///< Whether or not to rectify as if part of an image.  Set to false if whole image, and true if in
-                     /// ROI mode.
+  /// Written by grabThread_ as configurations are applied, read by publishThread_ to rebuild the CameraInfo.
+  ImageSettings image_settings_;
 
   // For GigE cameras:
   /// If true, GigE packet size is automatically determined, otherwise packet_size_ is used:
@@ -750,8 +1846,261 @@ private:
 
   /// Configuration:
   spinnaker_camera_driver::SpinnakerConfig config_;
+
+  // Updates queued by paramCallback, gainWBCallback and roiCallback for devicePoll, guarded by config_mutex_
+  std::mutex config_mutex_;
+  bool config_pending_;     ///< Whether config_ still has to be applied.
+  uint32_t pending_level_;  ///< Levels of config_ and every configuration it replaced since one was applied.
+  ros::WallTime config_requested_;  ///< When the oldest configuration still waiting was queued.
+  bool exposure_pending_;           ///< Whether pending_exposure_ still has to be applied.
+  image_exposure_msgs::ExposureSequence pending_exposure_;  ///< Latest from image_exposure_sequence.
+  bool roi_pending_;                           ///< Whether pending_roi_ still has to be applied.
+  sensor_msgs::RegionOfInterest pending_roi_;  ///< Latest from set_roi.
 };
 
 PLUGINLIB_EXPORT_CLASS(spinnaker_camera_driver::SpinnakerCameraNodelet,
                        nodelet::Nodelet)  // Needed for Nodelet declaration
+
+/**
+ * Runs several cameras in one nodelet, each as a SpinnakerCameraNodelet of its own.
+ *
+ * The cameras share the Spinnaker system and its camera list, so the buses are enumerated once rather than once per
+ * camera, and each camera keeps its own acquisition and publishing threads. Camera i publishes in the namespace
+ * names[i] next to this nodelet and reads its private parameters from names[i]/camera_nodelet. Any private parameter
+ * of this nodelet other than serials and names is passed on to every camera that does not set it itself.
+ *
+ * With synchronize set, frames are only published in sets holding one frame per camera. Frames are matched by the
+ * camera's frame ID or by their stamp, which should then come from the camera clock (time_stamp_mode "camera"), and
+ * every frame of a set is stamped with the time of the first camera's frame.
+ *
+ * The cameras connect and configure as soon as they are loaded, at most max_parallel_connects at a time.
+ */
+class SpinnakerMultiCameraNodelet : public nodelet::Nodelet
+{
+public:
+  SpinnakerMultiCameraNodelet() : sync_by_frame_id_(false), sets_published_(0), sets_discarded_(0)
+  {
+    statistics_.matched = 0;
+  }
+
+  ~SpinnakerMultiCameraNodelet()
+  {
+    // Take the cameras out of reach of synchronizeFrame before their threads are stopped
+    std::vector<boost::shared_ptr<SpinnakerCameraNodelet> > cameras;
+    {
+      std::lock_guard<std::mutex> scopedLock(sync_mutex_);
+      cameras.swap(cameras_);
+    }
+    // Wait for a set still being published, it got its camera pointers before the swap
+    {
+      std::lock_guard<std::mutex> scopedLock(publish_mutex_);
+    }
+
+    // Release the cameras in reverse order, the last one takes the shared Spinnaker system with it
+    while (!cameras.empty())
+      cameras.pop_back();
+  }
+
+private:
+  /*!
+  * \brief Frame sink of the cameras when synchronizing, publishes the sets the frame completes.
+  *
+  * Runs on the publishing thread of the camera the frame comes from. Only matching the frame holds sync_mutex_, so
+  * the other cameras can add their frames while a set is debayered and published. publish_mutex_ is taken before
+  * sync_mutex_ is released, which keeps the sets in the order they were completed and serializes publishFrame.
+  */
+  void synchronizeFrame(const size_t camera, const wfov_camera_msgs::WFOVImagePtr& wfov_image)
+  {
+    std::unique_lock<std::mutex> sync_lock(sync_mutex_);
+
+    const int64_t key = sync_by_frame_id_ ? static_cast<int64_t>(wfov_image->header.seq) :
+                                            static_cast<int64_t>(wfov_image->header.stamp.toNSec());
+    std::vector<std::vector<wfov_camera_msgs::WFOVImagePtr> > sets;
+    synchronizer_->add(camera, key, wfov_image, &sets);
+
+    // While starting up or shutting down not every camera can publish
+    if (!sets.empty() && cameras_.size() != synchronizer_->inputs())
+    {
+      sets_discarded_ += sets.size();
+      sets.clear();
+    }
+
+    // Raw pointers, the destructor holds on to the cameras until publish_mutex_ is free
+    std::vector<SpinnakerCameraNodelet*> cameras;
+    if (!sets.empty())
+    {
+      for (const boost::shared_ptr<SpinnakerCameraNodelet>& nodelet : cameras_)
+        cameras.push_back(nodelet.get());
+    }
+
+    // A frame that completes nothing only updates the diagnostics, and not while a set is being published
+    std::unique_lock<std::mutex> publish_lock(publish_mutex_, std::defer_lock);
+    if (!sets.empty())
+      publish_lock.lock();
+    else if (!publish_lock.try_lock())
+      return;
+    statistics_ = synchronizer_->statistics();
+    sets_published_ += sets.size();
+    sync_lock.unlock();
+
+    for (const std::vector<wfov_camera_msgs::WFOVImagePtr>& set : sets)
+    {
+      const ros::Time stamp = set.front()->header.stamp;
+      for (size_t i = 0; i < set.size(); ++i)
+      {
+        set[i]->header.stamp = stamp;
+        set[i]->image.header.stamp = stamp;
+        cameras[i]->publishFrame(set[i]);
+      }
+    }
+
+    updater_.update();
+  }
+
+  /// Runs from updater_.update() with publish_mutex_ held.
+  void synchronizerStatus(diagnostic_updater::DiagnosticStatusWrapper& stat)
+  {
+    stat.summary(diagnostic_msgs::DiagnosticStatus::OK, "OK");
+    stat.add("Match by", sync_by_frame_id_ ? "frame_id" : "stamp");
+    stat.add("Tolerance", synchronizer_->tolerance());
+    stat.add("Sets published", sets_published_);
+    stat.add("Sets discarded while cameras start or stop", sets_discarded_.load());
+    for (size_t i = 0; i < statistics_.unmatched.size(); ++i)
+    {
+      stat.add("Unmatched frames of " + camera_names_[i], statistics_.unmatched[i]);
+      stat.add("Dropped frames of " + camera_names_[i], statistics_.dropped[i]);
+      if (statistics_.dropped[i] > 0)
+        stat.mergeSummary(diagnostic_msgs::DiagnosticStatus::WARN, "Frames dropped waiting for a match");
+    }
+    if (sets_discarded_ > 0)
+      stat.mergeSummary(diagnostic_msgs::DiagnosticStatus::WARN, "Sets discarded while not every camera was running");
+  }
+
+  void onInit()
+  {
+    ros::NodeHandle& pnh = getMTPrivateNodeHandle();
+    const ros::WallTime start = ros::WallTime::now();
+
+    std::vector<std::string> serials;
+    XmlRpc::XmlRpcValue serials_xmlrpc;
+    pnh.getParam("serials", serials_xmlrpc);
+    if (serials_xmlrpc.getType() != XmlRpc::XmlRpcValue::TypeArray)
+    {
+      NODELET_ERROR("The serials parameter must be a list of camera serial numbers.");
+      return;
+    }
+    for (int i = 0; i < serials_xmlrpc.size(); ++i)
+    {
+      if (serials_xmlrpc[i].getType() == XmlRpc::XmlRpcValue::TypeInt)
+        serials.push_back(std::to_string(static_cast<int>(serials_xmlrpc[i])));
+      else if (serials_xmlrpc[i].getType() == XmlRpc::XmlRpcValue::TypeString)
+        serials.push_back(static_cast<std::string>(serials_xmlrpc[i]));
+      else
+        NODELET_WARN("Ignoring entry %d of serials, it is neither a number nor a string.", i);
+    }
+
+    std::vector<std::string> names;
+    pnh.param<std::vector<std::string> >("names", names, std::vector<std::string>());
+    if (!names.empty() && names.size() != serials.size())
+    {
+      NODELET_ERROR("Got %zu names for %zu serials, naming the cameras after their serials instead.", names.size(),
+                    serials.size());
+      names.clear();
+    }
+    for (size_t i = names.size(); i < serials.size(); ++i)
+      names.push_back("camera_" + serials[i]);
+    camera_names_ = names;
+
+    // Optionally publish only frames that were matched with a frame of every other camera
+    bool synchronize;
+    pnh.param<bool>("synchronize", synchronize, false);
+    if (synchronize)
+    {
+      std::string sync_key;
+      pnh.param<std::string>("sync_key", sync_key, "stamp");
+      if (sync_key != "stamp" && sync_key != "frame_id")
+      {
+        NODELET_WARN("Unknown sync_key '%s', using stamp.", sync_key.c_str());
+        sync_key = "stamp";
+      }
+      sync_by_frame_id_ = sync_key == "frame_id";
+
+      // In seconds when matching stamps, in frames when matching frame IDs
+      double sync_tolerance;
+      pnh.param<double>("sync_tolerance", sync_tolerance, sync_by_frame_id_ ? 0.0 : 0.002);
+      const int64_t tolerance = sync_by_frame_id_ ? static_cast<int64_t>(sync_tolerance) :
+                                                    static_cast<int64_t>(sync_tolerance * 1e9);
+      int sync_queue_size;
+      pnh.param<int>("sync_queue_size", sync_queue_size, 4);
+      synchronizer_.reset(new FrameSynchronizer<wfov_camera_msgs::WFOVImagePtr>(serials.size(), tolerance,
+                                                                                std::max(sync_queue_size, 1)));
+
+      updater_.setHardwareID("spinnaker_multi_camera");
+      updater_.add("Frame Synchronizer", this, &SpinnakerMultiCameraNodelet::synchronizerStatus);
+    }
+
+    // Connecting is slow for each camera, but connecting too many at once overloads the buses
+    int max_parallel_connects;
+    pnh.param<int>("max_parallel_connects", max_parallel_connects, 4);
+    system_ = SpinnakerSystem::instance();
+    system_->setMaxParallelConnects(std::max(max_parallel_connects, 0));
+
+    // Parameters shared by all the cameras
+    XmlRpc::XmlRpcValue shared_params;
+    pnh.getParam(pnh.getNamespace(), shared_params);
+
+    const std::string parent_namespace = ros::names::parentNamespace(getName());
+    for (size_t i = 0; i < serials.size(); ++i)
+    {
+      const std::string camera_name = ros::names::append(ros::names::append(parent_namespace, names[i]),
+                                                         "camera_nodelet");
+
+      if (shared_params.getType() == XmlRpc::XmlRpcValue::TypeStruct)
+      {
+        for (XmlRpc::XmlRpcValue::iterator param = shared_params.begin(); param != shared_params.end(); ++param)
+        {
+          const std::string param_name = ros::names::append(camera_name, param->first);
+          if (param->first != "serials" && param->first != "names" && !ros::param::has(param_name))
+            ros::param::set(param_name, param->second);
+        }
+      }
+      ros::param::set(ros::names::append(camera_name, "serial"), serials[i]);
+      if (!ros::param::has(ros::names::append(camera_name, "frame_id")))
+        ros::param::set(ros::names::append(camera_name, "frame_id"), names[i]);
+      if (!ros::param::has(ros::names::append(camera_name, "connect_on_start")))
+        ros::param::set(ros::names::append(camera_name, "connect_on_start"), true);
+
+      boost::shared_ptr<SpinnakerCameraNodelet> camera(new SpinnakerCameraNodelet());
+      if (synchronizer_)
+        camera->setFrameSink(boost::bind(&SpinnakerMultiCameraNodelet::synchronizeFrame, this, i, _1));
+      camera->init(camera_name, nodelet::M_string(), getMyArgv(), &getSTCallbackQueue(), &getMTCallbackQueue());
+      {
+        // The first frames may already reach synchronizeFrame
+        std::lock_guard<std::mutex> scopedLock(sync_mutex_);
+        cameras_.push_back(camera);
+      }
+      NODELET_INFO("Started camera %s with serial %s.", camera_name.c_str(), serials[i].c_str());
+    }
+
+    // Each camera connects on its own acquisition thread, see connect_on_start
+    NODELET_INFO("Loaded %zu cameras in %.3f s, they connect in the background.", cameras_.size(),
+                 (ros::WallTime::now() - start).toSec());
+  }
+
+  std::shared_ptr<SpinnakerSystem> system_;  ///< Holds on to the Spinnaker system while the cameras come and go.
+  std::vector<boost::shared_ptr<SpinnakerCameraNodelet> > cameras_;  ///< One nodelet per camera, in serials order.
+  std::vector<std::string> camera_names_;                             ///< Namespace of each camera.
+
+  // Synchronization of the cameras, synchronizer_ is null unless enabled
+  std::unique_ptr<FrameSynchronizer<wfov_camera_msgs::WFOVImagePtr> > synchronizer_;
+  bool sync_by_frame_id_;     ///< Whether frames are matched by frame ID rather than by stamp.
+  std::mutex sync_mutex_;     ///< Serializes matching frames across the publishing threads of the cameras.
+  std::mutex publish_mutex_;  ///< Serializes publishing the completed sets, taken while sync_mutex_ is still held.
+  FrameSynchronizer<wfov_camera_msgs::WFOVImagePtr>::Statistics statistics_;  ///< Copied under publish_mutex_.
+  uint64_t sets_published_;               ///< Guarded by publish_mutex_.
+  std::atomic<uint64_t> sets_discarded_;  ///< Completed sets not published because a camera was missing.
+  diagnostic_updater::Updater updater_;  ///< Publishes the synchronizer statistics.
+};
+
+PLUGINLIB_EXPORT_CLASS(spinnaker_camera_driver::SpinnakerMultiCameraNodelet, nodelet::Nodelet)
 }  // namespace spinnaker_camera_driver
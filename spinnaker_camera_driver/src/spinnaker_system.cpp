@@ -0,0 +1,190 @@
+/**
+Software License Agreement (BSD)
+
+\file      spinnaker_system.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "spinnaker_camera_driver/spinnaker_system.h"
+
+#include <ros/ros.h>
+
+#include <boost/thread/thread.hpp>
+
+#include <memory>
+#include <string>
+
+namespace spinnaker_camera_driver
+{
+std::shared_ptr<SpinnakerSystem> SpinnakerSystem::instance()
+{
+  static std::mutex instance_mutex;
+  static std::weak_ptr<SpinnakerSystem> shared_instance;
+
+  std::lock_guard<std::mutex> scopedLock(instance_mutex);
+  std::shared_ptr<SpinnakerSystem> system = shared_instance.lock();
+  if (!system)
+  {
+    system.reset(new SpinnakerSystem());
+    shared_instance = system;
+  }
+  return system;
+}
+
+SpinnakerSystem::SpinnakerSystem()
+  : system_(Spinnaker::System::GetInstance())
+  , cameras_(system_->GetCameras())
+  , max_parallel_connects_(0)
+  , connecting_(0)
+  , cameras_stale_(false)
+  , arrivals_(0)
+  , event_handler_(this)
+{
+  ROS_INFO_STREAM("[SpinnakerSystem]: Number of cameras detected: " << cameras_.GetSize());
+
+  try
+  {
+    system_->RegisterInterfaceEvent(event_handler_);
+  }
+  catch (const Spinnaker::Exception& e)
+  {
+    ROS_WARN_STREAM("[SpinnakerSystem]: Could not register for device arrival and removal, reconnecting after "
+                    "repeated grab timeouts only. Error: "
+                    << e.what());
+  }
+}
+
+SpinnakerSystem::~SpinnakerSystem()
+{
+  try
+  {
+    system_->UnregisterInterfaceEvent(event_handler_);
+  }
+  catch (const Spinnaker::Exception& e)
+  {
+    ROS_WARN_STREAM("[SpinnakerSystem]: Could not unregister device events. Error: " << e.what());
+  }
+  cameras_.Clear();
+  system_->ReleaseInstance();
+}
+
+Spinnaker::CameraPtr SpinnakerSystem::getCamera(const std::string& serial)
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  // Cleared before enumerating, so that events raised during the enumeration mark the new list stale again
+  if (cameras_stale_.exchange(false))
+  {
+    // Pick up cameras that arrived since the list was enumerated
+    cameras_.Clear();
+    cameras_ = system_->GetCameras();
+  }
+  if (serial.empty())
+    return cameras_.GetByIndex(0);
+  return cameras_.GetBySerial(serial);
+}
+
+void SpinnakerSystem::refresh()
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  cameras_stale_ = false;
+  cameras_.Clear();
+  cameras_ = system_->GetCameras();
+}
+
+uint64_t SpinnakerSystem::arrivals()
+{
+  std::lock_guard<std::mutex> scopedLock(event_mutex_);
+  return arrivals_;
+}
+
+uint64_t SpinnakerSystem::removals(const uint64_t serial)
+{
+  std::lock_guard<std::mutex> scopedLock(event_mutex_);
+  std::map<uint64_t, uint64_t>::const_iterator removal = removals_.find(serial);
+  return removal == removals_.end() ? 0 : removal->second;
+}
+
+bool SpinnakerSystem::waitForArrival(const uint64_t seen, const std::chrono::milliseconds& timeout)
+{
+  std::unique_lock<std::mutex> scopedLock(event_mutex_);
+  return device_arrived_.wait_for(scopedLock, timeout, [this, seen]() { return arrivals_ > seen; });
+}
+
+void SpinnakerSystem::onDeviceArrival(const uint64_t serial)
+{
+  ROS_INFO_STREAM("[SpinnakerSystem]: Camera " << serial << " arrived.");
+  // No lock on mutex_ here, Spinnaker raises the event from inside GetCameras() on the thread holding it
+  cameras_stale_ = true;
+  {
+    std::lock_guard<std::mutex> scopedLock(event_mutex_);
+    arrivals_++;
+  }
+  device_arrived_.notify_all();
+}
+
+void SpinnakerSystem::onDeviceRemoval(const uint64_t serial)
+{
+  ROS_INFO_STREAM("[SpinnakerSystem]: Camera " << serial << " removed.");
+  cameras_stale_ = true;
+  std::lock_guard<std::mutex> scopedLock(event_mutex_);
+  removals_[serial]++;
+}
+
+void SpinnakerSystem::setMaxParallelConnects(const size_t max_parallel_connects)
+{
+  {
+    std::lock_guard<std::mutex> scopedLock(connect_mutex_);
+    max_parallel_connects_ = max_parallel_connects;
+  }
+  connect_slot_released_.notify_all();
+}
+
+void SpinnakerSystem::acquireConnectSlot()
+{
+  std::unique_lock<std::mutex> scopedLock(connect_mutex_);
+  // Wait in short slices so that interrupting the thread, e.g. on shutdown, ends the wait
+  while (!connect_slot_released_.wait_for(scopedLock, std::chrono::milliseconds(100), [this]() {
+    return max_parallel_connects_ == 0 || connecting_ < max_parallel_connects_;
+  }))
+  {
+    if (boost::this_thread::interruption_requested())
+    {
+      scopedLock.unlock();
+      boost::this_thread::interruption_point();
+    }
+  }
+  connecting_++;
+}
+
+void SpinnakerSystem::releaseConnectSlot()
+{
+  {
+    std::lock_guard<std::mutex> scopedLock(connect_mutex_);
+    connecting_--;
+  }
+  connect_slot_released_.notify_one();
+}
+
+unsigned int SpinnakerSystem::numCameras()
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  return cameras_.GetSize();
+}
+}  // namespace spinnaker_camera_driver
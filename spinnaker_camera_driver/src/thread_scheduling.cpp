@@ -0,0 +1,166 @@
+/**
+Software License Agreement (BSD)
+
+\file      thread_scheduling.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "spinnaker_camera_driver/thread_scheduling.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace spinnaker_camera_driver
+{
+bool setCurrentThreadAffinity(const std::vector<int>& cpus, std::string* error)
+{
+  if (cpus.empty())
+    return true;
+
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (const int cpu : cpus)
+  {
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+    {
+      *error = "CPU index " + std::to_string(cpu) + " is out of range";
+      return false;
+    }
+    CPU_SET(cpu, &cpu_set);
+  }
+
+  const int result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (result != 0)
+  {
+    *error = std::strerror(result);
+    return false;
+  }
+  return true;
+}
+
+bool setCurrentThreadRealtime(const int priority, std::string* error)
+{
+  if (priority <= 0)
+    return true;
+
+  const int min_priority = sched_get_priority_min(SCHED_FIFO);
+  const int max_priority = sched_get_priority_max(SCHED_FIFO);
+  if (priority < min_priority || priority > max_priority)
+  {
+    *error = "priority " + std::to_string(priority) + " is outside [" + std::to_string(min_priority) + ", " +
+             std::to_string(max_priority) + "]";
+    return false;
+  }
+
+  sched_param param;
+  param.sched_priority = priority;
+  const int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+  if (result != 0)
+  {
+    *error = std::strerror(result);
+    return false;
+  }
+  return true;
+}
+
+bool lockProcessMemory(std::string* error)
+{
+  // With MCL_FUTURE every later allocation has to fit under RLIMIT_MEMLOCK, so an unprivileged process with a
+  // finite limit would start failing allocations instead of just running unlocked.
+  rlimit limit;
+  if (geteuid() != 0 && getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY)
+  {
+    *error = "RLIMIT_MEMLOCK is " + std::to_string(limit.rlim_cur) + " bytes, it has to be unlimited";
+    return false;
+  }
+
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+  {
+    *error = std::strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+std::string describeCurrentThreadScheduling()
+{
+  std::ostringstream description;
+
+  int policy = 0;
+  sched_param param;
+  if (pthread_getschedparam(pthread_self(), &policy, &param) == 0)
+  {
+    switch (policy)
+    {
+      case SCHED_FIFO:
+        description << "SCHED_FIFO priority " << param.sched_priority;
+        break;
+      case SCHED_RR:
+        description << "SCHED_RR priority " << param.sched_priority;
+        break;
+      case SCHED_OTHER:
+        description << "SCHED_OTHER";
+        break;
+      default:
+        description << "policy " << policy;
+    }
+  }
+  else
+  {
+    description << "unknown policy";
+  }
+
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0)
+  {
+    description << ", CPUs";
+    const char* separator = " ";
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+      if (CPU_ISSET(cpu, &cpu_set))
+      {
+        description << separator << cpu;
+        separator = ",";
+      }
+    }
+  }
+
+  return description.str();
+}
+
+double currentThreadCpuTime()
+{
+  struct timespec cpu_time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time) != 0)
+    return 0.0;
+  return cpu_time.tv_sec + 1e-9 * cpu_time.tv_nsec;
+}
+}  // namespace spinnaker_camera_driver
@@ -0,0 +1,239 @@
+/**
+Software License Agreement (BSD)
+
+\file      timestamp_estimator.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "spinnaker_camera_driver/timestamp_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace spinnaker_camera_driver
+{
+namespace
+{
+// Fewer samples than this give an offset that is noisier than the receive time itself.
+const size_t kMinSamples = 10;
+// Number of window minima the drift is fitted over.
+const size_t kMaxMinima = 10;
+}  // namespace
+
+TimestampEstimator::TimestampEstimator(const size_t window_size, const double latency)
+  : window_size_(std::max(window_size, kMinSamples))
+  , latency_(latency)
+  , block_count_(0)
+  , has_reference_(false)
+  , reference_camera_(0)
+  , last_camera_(0)
+  , slope_(1.0)
+  , has_anchor_(false)
+{
+  statistics_.resets = 0;
+  clear();
+}
+
+ros::Time TimestampEstimator::update(const uint64_t camera_stamp, const ros::Time& host_stamp)
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+
+  if (has_reference_ && camera_stamp <= last_camera_)
+  {
+    // The camera clock restarted (or the camera was swapped), the old samples no longer apply.
+    clear();
+    statistics_.resets++;
+  }
+
+  if (!has_reference_)
+    setReference(camera_stamp, host_stamp);
+  last_camera_ = camera_stamp;
+
+  Sample sample;
+  sample.camera = cameraSeconds(camera_stamp);
+  sample.host = (host_stamp - reference_host_).toSec();
+  samples_.push_back(sample);
+  while (samples_.size() > window_size_)
+    samples_.pop_front();
+
+  // Track the least delayed sample of each block of window_size_ samples for the drift fit.
+  if (block_count_ == 0 || sample.host - sample.camera < block_minimum_.host - block_minimum_.camera)
+    block_minimum_ = sample;
+  if (++block_count_ == window_size_)
+  {
+    minima_.push_back(block_minimum_);
+    while (minima_.size() > kMaxMinima)
+      minima_.pop_front();
+    block_count_ = 0;
+    fitDrift();
+  }
+
+  statistics_.samples = samples_.size();
+  if (has_anchor_)
+  {
+    // The anchor fixes the offset, what the frames add on top of it is their readout and transport latency
+    const double offset = anchor_.host - slope_ * anchor_.camera;
+    double min_delay = 0.0;
+    bool first = true;
+    for (const Sample& s : samples_)
+    {
+      const double delay = s.host - slope_ * s.camera - offset;
+      min_delay = first ? delay : std::min(min_delay, delay);
+      first = false;
+    }
+    double sum_squares = 0.0;
+    double max_delay = 0.0;
+    for (const Sample& s : samples_)
+    {
+      const double delay = s.host - slope_ * s.camera - offset - min_delay;
+      sum_squares += delay * delay;
+      max_delay = std::max(max_delay, delay);
+    }
+    statistics_.residual_rms = std::sqrt(sum_squares / samples_.size());
+    statistics_.residual_max = max_delay;
+    statistics_.latency = min_delay;
+
+    return reference_host_ + ros::Duration(offset + slope_ * sample.camera);
+  }
+  if (samples_.size() < kMinSamples)
+    return host_stamp;
+
+  // The least delayed sample bounds the offset between the clocks, every other sample arrived later than that.
+  double min_offset = 0.0;
+  bool first = true;
+  for (const Sample& s : samples_)
+  {
+    const double offset = s.host - slope_ * s.camera;
+    min_offset = first ? offset : std::min(min_offset, offset);
+    first = false;
+  }
+
+  double sum_squares = 0.0;
+  double max_delay = 0.0;
+  for (const Sample& s : samples_)
+  {
+    const double delay = s.host - slope_ * s.camera - min_offset;
+    sum_squares += delay * delay;
+    max_delay = std::max(max_delay, delay);
+  }
+  statistics_.residual_rms = std::sqrt(sum_squares / samples_.size());
+  statistics_.residual_max = max_delay;
+
+  return reference_host_ + ros::Duration(min_offset - latency_ + slope_ * sample.camera);
+}
+
+void TimestampEstimator::anchor(const uint64_t camera_stamp, const ros::Time& host_before, const ros::Time& host_after)
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+
+  // The latch is taken after the last frame was received, so it can only be earlier if the clock restarted
+  if (has_reference_ && camera_stamp < last_camera_)
+  {
+    clear();
+    statistics_.resets++;
+  }
+
+  const double round_trip = (host_after - host_before).toSec();
+  const ros::Time host_stamp = host_before + ros::Duration(0.5 * round_trip);
+  if (!has_reference_)
+    setReference(camera_stamp, host_stamp);
+
+  anchor_.camera = cameraSeconds(camera_stamp);
+  anchor_.host = (host_stamp - reference_host_).toSec();
+  has_anchor_ = true;
+  statistics_.anchored = true;
+  statistics_.anchor_uncertainty = 0.5 * round_trip;
+}
+
+void TimestampEstimator::reset()
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  clear();
+}
+
+TimestampEstimator::Statistics TimestampEstimator::statistics() const
+{
+  std::lock_guard<std::mutex> scopedLock(mutex_);
+  return statistics_;
+}
+
+void TimestampEstimator::clear()
+{
+  samples_.clear();
+  minima_.clear();
+  block_count_ = 0;
+  has_reference_ = false;
+  slope_ = 1.0;
+  has_anchor_ = false;
+
+  statistics_.samples = 0;
+  statistics_.residual_rms = 0.0;
+  statistics_.residual_max = 0.0;
+  statistics_.drift_ppm = 0.0;
+  statistics_.anchored = false;
+  statistics_.anchor_uncertainty = 0.0;
+  statistics_.latency = 0.0;
+}
+
+void TimestampEstimator::setReference(const uint64_t camera_stamp, const ros::Time& host_stamp)
+{
+  reference_camera_ = camera_stamp;
+  reference_host_ = host_stamp;
+  has_reference_ = true;
+  last_camera_ = 0;  // No frame yet, a frame exposed before an anchor may still arrive after it
+}
+
+double TimestampEstimator::cameraSeconds(const uint64_t camera_stamp) const
+{
+  // An anchor may be latched before the first frame, signed so that it can lie before the reference
+  return static_cast<double>(static_cast<int64_t>(camera_stamp - reference_camera_)) * 1e-9;
+}
+
+void TimestampEstimator::fitDrift()
+{
+  if (minima_.size() < 2)
+    return;
+
+  const double n = static_cast<double>(minima_.size());
+  double mean_camera = 0.0;
+  double mean_host = 0.0;
+  for (const Sample& s : minima_)
+  {
+    mean_camera += s.camera;
+    mean_host += s.host;
+  }
+  mean_camera /= n;
+  mean_host /= n;
+
+  double covariance = 0.0;
+  double variance = 0.0;
+  for (const Sample& s : minima_)
+  {
+    const double dc = s.camera - mean_camera;
+    covariance += dc * (s.host - mean_host);
+    variance += dc * dc;
+  }
+  if (variance <= 0.0)
+    return;
+
+  slope_ = covariance / variance;
+  statistics_.drift_ppm = (slope_ - 1.0) * 1e6;
+}
+}  // namespace spinnaker_camera_driver
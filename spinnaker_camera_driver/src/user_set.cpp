@@ -0,0 +1,99 @@
+/**
+Software License Agreement (BSD)
+
+\file      user_set.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "spinnaker_camera_driver/user_set.h"
+
+#include <dynamic_reconfigure/Config.h>
+
+#include <cstdio>
+#include <fstream>
+#include <ios>
+#include <string>
+
+namespace spinnaker_camera_driver
+{
+namespace
+{
+// FNV-1a, std::hash is neither specified nor required to be stable across builds
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+void hashString(const std::string& text, uint64_t* hash)
+{
+  for (const char c : text)
+    *hash = (*hash ^ static_cast<unsigned char>(c)) * FNV_PRIME;
+  // Hash a terminating zero as well, so that "ab" followed by "c" differs from "a" followed by "bc"
+  *hash *= FNV_PRIME;
+}
+}  // namespace
+
+uint64_t hashConfiguration(const spinnaker_camera_driver::SpinnakerConfig& config, const std::string& salt)
+{
+  dynamic_reconfigure::Config msg;
+  config.__toMessage__(msg);
+
+  uint64_t hash = FNV_OFFSET_BASIS;
+  hashString(salt, &hash);
+  for (const dynamic_reconfigure::BoolParameter& param : msg.bools)
+  {
+    hashString(param.name, &hash);
+    hashString(param.value ? "1" : "0", &hash);
+  }
+  for (const dynamic_reconfigure::IntParameter& param : msg.ints)
+  {
+    hashString(param.name, &hash);
+    hashString(std::to_string(param.value), &hash);
+  }
+  for (const dynamic_reconfigure::StrParameter& param : msg.strs)
+  {
+    hashString(param.name, &hash);
+    hashString(param.value, &hash);
+  }
+  for (const dynamic_reconfigure::DoubleParameter& param : msg.doubles)
+  {
+    char value[32];
+    std::snprintf(value, sizeof(value), "%.17g", param.value);
+    hashString(param.name, &hash);
+    hashString(value, &hash);
+  }
+  return hash;
+}
+
+bool readUserSetHash(const std::string& path, const std::string& user_set, uint64_t* hash)
+{
+  std::ifstream file(path.c_str());
+  std::string stored_user_set;
+  uint64_t stored_hash = 0;
+  if (!(file >> stored_user_set >> std::hex >> stored_hash) || stored_user_set != user_set)
+    return false;
+  *hash = stored_hash;
+  return true;
+}
+
+bool writeUserSetHash(const std::string& path, const std::string& user_set, uint64_t hash)
+{
+  std::ofstream file(path.c_str(), std::ios::trunc);
+  file << user_set << " " << std::hex << hash << std::endl;
+  return static_cast<bool>(file);
+}
+}  // namespace spinnaker_camera_driver
@@ -0,0 +1,103 @@
+/**
+Software License Agreement (BSD)
+
+\file      benchmark_enumeration.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Times looking up N cameras the way separate nodelets did, each enumerating every bus with its own camera list,
+// against the shared SpinnakerSystem, which enumerates once. Runs against the cameras actually connected; with no
+// serials given it looks up the first camera N times, which enumerates just the same.
+//
+// Usage: benchmark_enumeration [cameras] [serial ...]
+
+#include "spinnaker_camera_driver/spinnaker_system.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using spinnaker_camera_driver::SpinnakerSystem;
+
+namespace
+{
+double millisecondsSince(const std::chrono::steady_clock::time_point& start)
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  const int cameras = argc > 1 ? std::atoi(argv[1]) : 6;
+  if (cameras <= 0)
+  {
+    std::fprintf(stderr, "Usage: %s [cameras] [serial ...]\n", argv[0]);
+    return 1;
+  }
+  std::vector<std::string> serials;
+  for (int i = 0; i < cameras; ++i)
+    serials.push_back(argc > 2 ? argv[2 + i % (argc - 2)] : "");
+
+  try
+  {
+    // One system reference and one camera list per camera, all alive at once like separate nodelets
+    {
+      std::vector<Spinnaker::SystemPtr> systems;
+      std::vector<Spinnaker::CameraList> lists;
+      int found = 0;
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      for (const std::string& serial : serials)
+      {
+        systems.push_back(Spinnaker::System::GetInstance());
+        lists.push_back(systems.back()->GetCameras());
+        Spinnaker::CameraPtr camera = serial.empty() ? lists.back().GetByIndex(0) : lists.back().GetBySerial(serial);
+        found += camera ? 1 : 0;
+      }
+      std::printf("Camera list per camera:  %9.1f ms for %d cameras (%d found)\n", millisecondsSince(start), cameras,
+                  found);
+      for (Spinnaker::CameraList& list : lists)
+        list.Clear();
+      for (Spinnaker::SystemPtr& system : systems)
+        system->ReleaseInstance();
+    }
+
+    {
+      int found = 0;
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      std::vector<std::shared_ptr<SpinnakerSystem> > systems;
+      for (const std::string& serial : serials)
+      {
+        systems.push_back(SpinnakerSystem::instance());
+        found += systems.back()->getCamera(serial) ? 1 : 0;
+      }
+      std::printf("Shared SpinnakerSystem:  %9.1f ms for %d cameras (%d found)\n", millisecondsSince(start), cameras,
+                  found);
+    }
+  }
+  catch (const Spinnaker::Exception& e)
+  {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
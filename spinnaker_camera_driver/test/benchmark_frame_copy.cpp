@@ -0,0 +1,125 @@
+/**
+Software License Agreement (BSD)
+
+\file      benchmark_frame_copy.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Measures the bytes copied and the time spent per frame between the stream buffer and the published image_raw
+// message, for the path the driver used to take and the one it takes now. A static buffer stands in for the
+// Spinnaker stream buffer, so no camera is needed.
+//
+// Usage: benchmark_frame_copy [width] [height] [frames]
+
+#include "spinnaker_camera_driver/message_pool.h"
+
+#include <sensor_msgs/Image.h>
+#include <sensor_msgs/fill_image.h>
+#include <sensor_msgs/image_encodings.h>
+#include <wfov_camera_msgs/WFOVImage.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct Result
+{
+  double bytes_copied;  ///< Per frame, including zero filling a newly sized vector.
+  double milliseconds;  ///< Per frame.
+};
+
+/// What happened per frame before: a new message filled by fillImage, then a deep copy for image_transport.
+Result previousPath(const std::vector<uint8_t>& buffer, const uint32_t width, const uint32_t height, const int frames)
+{
+  uint64_t bytes_copied = 0;
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; ++i)
+  {
+    wfov_camera_msgs::WFOVImagePtr wfov_image(new wfov_camera_msgs::WFOVImage);
+    sensor_msgs::fillImage(wfov_image->image, sensor_msgs::image_encodings::BAYER_RGGB8, height, width, width,
+                           buffer.data());
+    // fillImage zero fills the vector it resizes before copying into it
+    bytes_copied += 2 * wfov_image->image.data.size();
+
+    sensor_msgs::ImagePtr image(new sensor_msgs::Image(wfov_image->image));
+    bytes_copied += image->data.size();
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return Result{ static_cast<double>(bytes_copied) / frames, 1e3 * seconds / frames };
+}
+
+/// What happens per frame now: a recycled message, one copy out of the buffer and an aliasing image pointer.
+Result currentPath(const std::vector<uint8_t>& buffer, const uint32_t width, const uint32_t height, const int frames)
+{
+  spinnaker_camera_driver::MessagePool<wfov_camera_msgs::WFOVImage> pool(8);
+  uint64_t bytes_copied = 0;
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; ++i)
+  {
+    wfov_camera_msgs::WFOVImagePtr wfov_image = pool.acquire();
+    sensor_msgs::Image& raw = wfov_image->image;
+    raw.encoding = sensor_msgs::image_encodings::BAYER_RGGB8;
+    raw.height = height;
+    raw.width = width;
+    raw.step = width;
+    const size_t size = buffer.size();
+    // A recycled message already has the capacity, so assign copies without zero filling
+    if (raw.data.capacity() < size)
+      bytes_copied += size;
+    raw.data.assign(buffer.data(), buffer.data() + size);
+    bytes_copied += size;
+
+    sensor_msgs::ImagePtr image(wfov_image, &wfov_image->image);
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return Result{ static_cast<double>(bytes_copied) / frames, 1e3 * seconds / frames };
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  // Defaults to a 20 MP Bayer frame
+  const uint32_t width = argc > 1 ? std::atoi(argv[1]) : 5472;
+  const uint32_t height = argc > 2 ? std::atoi(argv[2]) : 3648;
+  const int frames = argc > 3 ? std::atoi(argv[3]) : 100;
+  if (width == 0 || height == 0 || frames <= 0)
+  {
+    std::fprintf(stderr, "Usage: %s [width] [height] [frames]\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<uint8_t> buffer(static_cast<size_t>(width) * height);
+  for (size_t i = 0; i < buffer.size(); ++i)
+    buffer[i] = static_cast<uint8_t>(i * 31);
+
+  const double frame_mb = buffer.size() / 1e6;
+  std::printf("%u x %u bayer_rggb8 (%.1f MB), %d frames\n", width, height, frame_mb, frames);
+  const Result previous = previousPath(buffer, width, height, frames);
+  std::printf("fillImage + deep copy:   %6.1f MB copied/frame, %7.3f ms/frame\n", previous.bytes_copied / 1e6,
+              previous.milliseconds);
+  const Result current = currentPath(buffer, width, height, frames);
+  std::printf("pooled assign + alias:   %6.1f MB copied/frame, %7.3f ms/frame\n", current.bytes_copied / 1e6,
+              current.milliseconds);
+  return 0;
+}
@@ -0,0 +1,106 @@
+/**
+Software License Agreement (BSD)
+
+\file      benchmark_node_lookups.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Counts the node requests a reconfigure makes and how many of them still go through the node map. Before the node
+// cache every request was a lookup by name, so the requests are what the same reconfigure would have looked up
+// without the cache and the lookups what it looks up with it.
+//
+// Reconfigures only write the features that changed, so the slider changes are counted twice: as they are applied
+// now, and written whole the way every reconfigure used to be, which counts the image format on top. The camera
+// applies a configuration whole after connecting, so the latter reconnects first and leaves the connect out.
+//
+// Usage: benchmark_node_lookups [serial]
+
+#include "spinnaker_camera_driver/SpinnakerCamera.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using spinnaker_camera_driver::SpinnakerCamera;
+
+namespace
+{
+void report(const char* name, const uint64_t lookups, const uint64_t hits)
+{
+  std::printf("%-24s %5lu node requests, %5lu node map lookups\n", name, static_cast<unsigned long>(lookups + hits),
+              static_cast<unsigned long>(lookups));
+}
+
+void reconfigure(SpinnakerCamera* camera, const char* name, const spinnaker_camera_driver::SpinnakerConfig& config,
+                 const uint32_t level)
+{
+  uint64_t lookups_before;
+  uint64_t hits_before;
+  camera->getNodeCacheStatistics(&lookups_before, &hits_before);
+  camera->setNewConfiguration(config, level);
+  uint64_t lookups;
+  uint64_t hits;
+  camera->getNodeCacheStatistics(&lookups, &hits);
+  report(name, lookups - lookups_before, hits - hits_before);
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  SpinnakerCamera camera;
+  try
+  {
+    if (argc > 1)
+      camera.setDesiredCamera(std::strtoul(argv[1], nullptr, 10));
+    camera.connect();
+
+    uint64_t lookups;
+    uint64_t hits;
+    camera.getNodeCacheStatistics(&lookups, &hits);
+    report("connect", lookups, hits);
+
+    spinnaker_camera_driver::SpinnakerConfig config = spinnaker_camera_driver::SpinnakerConfig::__getDefault__();
+    reconfigure(&camera, "first configuration", config, SpinnakerCamera::LEVEL_RECONFIGURE_STOP);
+
+    // What dragging the exposure and gain sliders sends
+    config.exposure_auto = "Off";
+    config.exposure_time = 5000.0;
+    config.auto_gain = "Off";
+    config.gain = 6.0;
+    reconfigure(&camera, "exposure and gain", config, SpinnakerCamera::LEVEL_RECONFIGURE_RUNNING);
+    config.exposure_time = 6000.0;
+    config.gain = 7.0;
+    reconfigure(&camera, "exposure and gain again", config, SpinnakerCamera::LEVEL_RECONFIGURE_RUNNING);
+
+    camera.disconnect();
+    camera.connect();
+    config.exposure_time = 7000.0;
+    config.gain = 8.0;
+    reconfigure(&camera, "exposure and gain whole", config, SpinnakerCamera::LEVEL_RECONFIGURE_RUNNING);
+
+    camera.disconnect();
+  }
+  catch (const std::exception& e)
+  {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
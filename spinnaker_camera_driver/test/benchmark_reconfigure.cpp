@@ -0,0 +1,123 @@
+/**
+Software License Agreement (BSD)
+
+\file      benchmark_reconfigure.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Times Camera::setNewConfiguration and needsAcquisitionStop against a simulated node map, see fake_node_map.h, for
+// dragging a slider and for a stop-level change. Each is timed written whole, the way every reconfigure used to be
+// written, and written as it is now, only what changed. The node map is in memory, so the write latency stands in
+// for the round trip of a write to a camera.
+//
+// Usage: benchmark_reconfigure [write_latency_us] [iterations]
+
+#include "spinnaker_camera_driver/camera.h"
+
+#include "fake_node_map.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+using spinnaker_camera_driver::Camera;
+using spinnaker_camera_driver::NodeCache;
+using spinnaker_camera_driver::SpinnakerConfig;
+using spinnaker_camera_driver::fakeNodeMap;
+
+namespace
+{
+/// Can forget what was applied, so that the next configuration is written whole.
+class BenchmarkCamera : public Camera
+{
+public:
+  explicit BenchmarkCamera(NodeCache* node_map) : Camera(node_map)
+  {
+  }
+
+  void forget()
+  {
+    configurationApplied(applied_config_, false);
+  }
+};
+
+typedef void (*ChangeFunction)(SpinnakerConfig* config, const int iteration);
+
+void moveGainSlider(SpinnakerConfig* config, const int iteration)
+{
+  config->gain = 5.0 + iteration % 2;
+}
+
+void toggleBinning(SpinnakerConfig* config, const int iteration)
+{
+  config->image_format_x_binning = 1 + iteration % 2;
+  config->image_format_y_binning = 1 + iteration % 2;
+}
+
+void run(const char* name, ChangeFunction change, const uint32_t level, const bool whole, const int iterations)
+{
+  NodeCache node_cache(nullptr);
+  BenchmarkCamera camera(&node_cache);
+  SpinnakerConfig config = SpinnakerConfig::__getDefault__();
+  config.auto_gain = "Off";
+  camera.setNewConfiguration(config, Camera::LEVEL_RECONFIGURE_STOP);
+  fakeNodeMap().writes.clear();
+
+  double reconfigure_seconds = 0.0;
+  double stop_check_seconds = 0.0;
+  for (int i = 0; i < iterations; ++i)
+  {
+    change(&config, i + 1);
+    if (whole)
+      camera.forget();
+
+    const std::chrono::steady_clock::time_point check_start = std::chrono::steady_clock::now();
+    // The result is not used here, SpinnakerCamera decides on it whether to stop acquisition
+    camera.needsAcquisitionStop(config);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    camera.setNewConfiguration(config, level);
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    stop_check_seconds += std::chrono::duration<double>(start - check_start).count();
+    reconfigure_seconds += std::chrono::duration<double>(end - start).count();
+  }
+
+  std::printf("%-30s %9.1f us per reconfigure, %5.1f writes, %6.2f us per needsAcquisitionStop\n", name,
+              1e6 * reconfigure_seconds / iterations, static_cast<double>(fakeNodeMap().writes.size()) / iterations,
+              1e6 * stop_check_seconds / iterations);
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  const int write_latency = argc > 1 ? std::atoi(argv[1]) : 100;
+  const int iterations = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 100;
+
+  fakeNodeMap().reset();
+  fakeNodeMap().write_latency = std::chrono::microseconds(write_latency);
+  std::printf("%d us per write, %d iterations\n", write_latency, iterations);
+
+  run("gain slider, written whole", moveGainSlider, Camera::LEVEL_RECONFIGURE_RUNNING, true, iterations);
+  run("gain slider, changes only", moveGainSlider, Camera::LEVEL_RECONFIGURE_RUNNING, false, iterations);
+  run("binning, written whole", toggleBinning, Camera::LEVEL_RECONFIGURE_STOP, true, iterations);
+  run("binning, changes only", toggleBinning, Camera::LEVEL_RECONFIGURE_STOP, false, iterations);
+  return 0;
+}
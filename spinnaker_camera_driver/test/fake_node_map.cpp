@@ -0,0 +1,228 @@
+/**
+Software License Agreement (BSD)
+
+\file      fake_node_map.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// NodeCache and ConfigTransaction on the FakeNodeMap, see fake_node_map.h. Node handles do not exist here, so
+// getNode() always returns a null handle, and a transaction that is not committed forgets its writes without undoing
+// them.
+
+#include "fake_node_map.h"
+
+#include "spinnaker_camera_driver/config_transaction.h"
+#include "spinnaker_camera_driver/node_cache.h"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace spinnaker_camera_driver
+{
+FakeNodeMap& fakeNodeMap()
+{
+  static FakeNodeMap node_map;
+  return node_map;
+}
+
+namespace
+{
+bool writable(const std::string& property_name)
+{
+  const FakeNodeMap& node_map = fakeNodeMap();
+  return !node_map.missing.count(property_name) && !node_map.read_only.count(property_name);
+}
+
+void recordWrite(const std::string& property_name, const std::string& value)
+{
+  FakeNodeMap& node_map = fakeNodeMap();
+  node_map.writes.push_back(property_name + "=" + value);
+  if (node_map.write_latency.count() > 0)
+    std::this_thread::sleep_for(node_map.write_latency);
+}
+
+bool readNumber(const Spinnaker::GenICam::gcstring& name, double* value)
+{
+  const FakeNodeMap& node_map = fakeNodeMap();
+  std::map<std::string, double>::const_iterator found = node_map.numbers.find(name.c_str());
+  if (node_map.missing.count(name.c_str()) || found == node_map.numbers.end())
+    return false;
+  *value = found->second;
+  return true;
+}
+}  // namespace
+
+NodeCache::NodeCache(Spinnaker::GenApi::INodeMap* node_map) : node_map_(node_map), lookups_(0), hits_(0)
+{
+}
+
+Spinnaker::GenApi::CNodePtr NodeCache::getNode(const Spinnaker::GenICam::gcstring& /* name */)
+{
+  return 0;
+}
+
+void NodeCache::probe(const std::vector<std::string>& /* names */)
+{
+}
+
+bool NodeCache::getCapability(const std::string& /* name */, Capability* /* capability */) const
+{
+  return false;
+}
+
+std::vector<std::pair<std::string, NodeCache::Capability> > NodeCache::getCapabilities() const
+{
+  return std::vector<std::pair<std::string, Capability> >();
+}
+
+bool NodeCache::isAvailable(const Spinnaker::GenICam::gcstring& name)
+{
+  return !fakeNodeMap().missing.count(name.c_str());
+}
+
+bool NodeCache::isImplemented(const Spinnaker::GenICam::gcstring& name)
+{
+  return !fakeNodeMap().missing.count(name.c_str());
+}
+
+bool NodeCache::isWritable(const Spinnaker::GenICam::gcstring& name)
+{
+  return writable(name.c_str());
+}
+
+bool NodeCache::readInteger(const Spinnaker::GenICam::gcstring& name, int64_t* value)
+{
+  double number;
+  if (!readNumber(name, &number))
+    return false;
+  *value = static_cast<int64_t>(number);
+  return true;
+}
+
+bool NodeCache::readFloat(const Spinnaker::GenICam::gcstring& name, double* value)
+{
+  return readNumber(name, value);
+}
+
+const std::string& NodeCache::id()
+{
+  id_ = "fake";
+  return id_;
+}
+
+uint64_t NodeCache::lookups() const
+{
+  return 0;
+}
+
+uint64_t NodeCache::hits() const
+{
+  return 0;
+}
+
+ConfigTransaction::ConfigTransaction(NodeCache* node_map) : node_map_(node_map), done_(false)
+{
+}
+
+ConfigTransaction::~ConfigTransaction()
+{
+  if (!done_)
+    rollback();
+}
+
+bool ConfigTransaction::set(const std::string& property_name, const std::string& entry_name)
+{
+  if (!writable(property_name))
+  {
+    skipped_.push_back(property_name);
+    return false;
+  }
+  fakeNodeMap().entries[property_name] = entry_name;
+  recordWrite(property_name, entry_name);
+  return true;
+}
+
+bool ConfigTransaction::set(const std::string& property_name, const char* entry_name)
+{
+  return set(property_name, std::string(entry_name));
+}
+
+bool ConfigTransaction::set(const std::string& property_name, float value)
+{
+  if (!writable(property_name))
+  {
+    skipped_.push_back(property_name);
+    return false;
+  }
+  fakeNodeMap().numbers[property_name] = value;
+  std::ostringstream written;
+  written << value;
+  recordWrite(property_name, written.str());
+  return true;
+}
+
+bool ConfigTransaction::set(const std::string& property_name, int value)
+{
+  if (!writable(property_name))
+  {
+    skipped_.push_back(property_name);
+    return false;
+  }
+  fakeNodeMap().numbers[property_name] = value;
+  recordWrite(property_name, std::to_string(value));
+  return true;
+}
+
+bool ConfigTransaction::set(const std::string& property_name, bool value)
+{
+  if (!writable(property_name))
+  {
+    skipped_.push_back(property_name);
+    return false;
+  }
+  fakeNodeMap().numbers[property_name] = value ? 1.0 : 0.0;
+  recordWrite(property_name, value ? "true" : "false");
+  return true;
+}
+
+bool ConfigTransaction::setMax(const std::string& property_name)
+{
+  if (!writable(property_name))
+  {
+    skipped_.push_back(property_name);
+    return false;
+  }
+  recordWrite(property_name, "max");
+  return true;
+}
+
+void ConfigTransaction::commit()
+{
+  done_ = true;
+}
+
+void ConfigTransaction::rollback()
+{
+  done_ = true;
+}
+}  // namespace spinnaker_camera_driver
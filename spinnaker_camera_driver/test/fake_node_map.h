@@ -0,0 +1,90 @@
+/**
+Software License Agreement (BSD)
+
+\file      fake_node_map.h
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// A node map held in memory, standing in for a camera in tests and benchmarks of Camera. Linking fake_node_map.cpp
+// instead of node_cache.cpp and config_transaction.cpp makes NodeCache and ConfigTransaction work on it, so Camera
+// runs unchanged while every write is recorded in order.
+#ifndef SPINNAKER_CAMERA_DRIVER_TEST_FAKE_NODE_MAP_H
+#define SPINNAKER_CAMERA_DRIVER_TEST_FAKE_NODE_MAP_H
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace spinnaker_camera_driver
+{
+struct FakeNodeMap
+{
+  std::map<std::string, double> numbers;       ///< Integer, float and boolean features.
+  std::map<std::string, std::string> entries;  ///< Enumerations, by the name of the selected entry.
+  std::set<std::string> missing;               ///< Features the camera does not implement.
+  std::set<std::string> read_only;             ///< Features that cannot be written at the moment.
+  std::vector<std::string> writes;             ///< Every write as name=value, in order.
+  std::chrono::microseconds write_latency;     ///< Time each write takes, as a round trip to a camera would.
+
+  /// Starts over with a camera that has a 1000x800 sensor and a full size ROI.
+  void reset()
+  {
+    numbers.clear();
+    entries.clear();
+    missing.clear();
+    read_only.clear();
+    writes.clear();
+    write_latency = std::chrono::microseconds(0);
+    numbers["HeightMax"] = 800;
+    numbers["WidthMax"] = 1000;
+    numbers["Height"] = 800;
+    numbers["Width"] = 1000;
+    numbers["OffsetX"] = 0;
+    numbers["OffsetY"] = 0;
+  }
+
+  /// Whether the property was written since writes was last cleared.
+  bool written(const std::string& property_name) const
+  {
+    for (const std::string& write : writes)
+    {
+      if (write.compare(0, property_name.size() + 1, property_name + "=") == 0)
+        return true;
+    }
+    return false;
+  }
+
+  /// Position of a write such as Width=500 in writes, or -1 if there was no such write.
+  int writeIndex(const std::string& write) const
+  {
+    for (size_t i = 0; i < writes.size(); ++i)
+    {
+      if (writes[i] == write)
+        return static_cast<int>(i);
+    }
+    return -1;
+  }
+};
+
+/// The node map every NodeCache and ConfigTransaction works on.
+FakeNodeMap& fakeNodeMap();
+}  // namespace spinnaker_camera_driver
+#endif  // SPINNAKER_CAMERA_DRIVER_TEST_FAKE_NODE_MAP_H
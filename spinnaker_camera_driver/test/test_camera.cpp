@@ -0,0 +1,317 @@
+/**
+Software License Agreement (BSD)
+
+\file      test_camera.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "spinnaker_camera_driver/camera.h"
+
+#include "fake_node_map.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using spinnaker_camera_driver::Camera;
+using spinnaker_camera_driver::CameraModel;
+using spinnaker_camera_driver::ConfigChanges;
+using spinnaker_camera_driver::FakeNodeMap;
+using spinnaker_camera_driver::NodeCache;
+using spinnaker_camera_driver::SpinnakerConfig;
+using spinnaker_camera_driver::fakeNodeMap;
+
+namespace
+{
+/// Exposes the comparison against the last applied configuration.
+class TestCamera : public Camera
+{
+public:
+  explicit TestCamera(NodeCache* node_map, const CameraModel model = spinnaker_camera_driver::MODEL_BLACKFLY_S)
+    : Camera(node_map, model)
+  {
+  }
+
+  using Camera::diffConfiguration;
+};
+
+class CameraTest : public ::testing::Test
+{
+protected:
+  CameraTest() : node_cache_(nullptr), config_(SpinnakerConfig::__getDefault__())
+  {
+    fakeNodeMap().reset();
+  }
+
+  /// Applies config_ with nothing recorded before, then starts over with the writes.
+  void applyFirst(Camera* camera)
+  {
+    camera->setNewConfiguration(config_, Camera::LEVEL_RECONFIGURE_STOP);
+    fakeNodeMap().writes.clear();
+  }
+
+  NodeCache node_cache_;
+  SpinnakerConfig config_;
+};
+}  // namespace
+
+TEST_F(CameraTest, firstConfigurationWritesEverything)
+{
+  TestCamera camera(&node_cache_);
+  EXPECT_FALSE(camera.hasAppliedConfiguration());
+  EXPECT_TRUE(camera.needsAcquisitionStop(config_));
+
+  fakeNodeMap().writes.clear();
+  camera.setNewConfiguration(config_, Camera::LEVEL_RECONFIGURE_STOP);
+  EXPECT_TRUE(camera.hasAppliedConfiguration());
+  for (const char* property_name : { "BinningVertical", "PixelFormat", "AcquisitionFrameRate", "TriggerMode",
+                                     "ExposureAuto", "GainAuto", "BlackLevel", "Gamma", "ReverseX" })
+    EXPECT_TRUE(fakeNodeMap().written(property_name)) << property_name;
+}
+
+TEST_F(CameraTest, unchangedConfigurationWritesNothing)
+{
+  TestCamera camera(&node_cache_);
+  applyFirst(&camera);
+
+  camera.setNewConfiguration(config_, Camera::LEVEL_RECONFIGURE_RUNNING);
+  EXPECT_TRUE(fakeNodeMap().writes.empty());
+  EXPECT_FALSE(camera.needsAcquisitionStop(config_));
+}
+
+TEST_F(CameraTest, sliderChangeWritesItsGroupOnly)
+{
+  TestCamera camera(&node_cache_);
+  applyFirst(&camera);
+
+  config_.brightness = 2.5;
+  EXPECT_FALSE(camera.needsAcquisitionStop(config_));
+  camera.setNewConfiguration(config_, Camera::LEVEL_RECONFIGURE_RUNNING);
+  EXPECT_EQ(std::vector<std::string>({ "BlackLevel=2.5" }), fakeNodeMap().writes);
+}
+
+TEST_F(CameraTest, dependentGroupsChangeTogether)
+{
+  TestCamera camera(&node_cache_);
+  applyFirst(&camera);
+
+  SpinnakerConfig config = config_;
+  config.acquisition_frame_rate = 30.0;
+  ConfigChanges changes = camera.diffConfiguration(config);
+  EXPECT_TRUE(changes.frame_rate);
+  EXPECT_TRUE(changes.exposure);
+  EXPECT_FALSE(changes.image_format);
+  EXPECT_FALSE(changes.gain);
+
+  config = config_;
+  config.trigger_source = "Line2";
+  changes = camera.diffConfiguration(config);
+  EXPECT_TRUE(changes.trigger_setup);
+  EXPECT_TRUE(changes.trigger_mode);
+  EXPECT_FALSE(changes.frame_rate);
+
+  config = config_;
+  config.image_format_y_binning = 2;
+  changes = camera.diffConfiguration(config);
+  EXPECT_TRUE(changes.image_format);
+  EXPECT_TRUE(changes.frame_rate);
+  EXPECT_TRUE(changes.exposure);
+}
+
+TEST_F(CameraTest, lockedFeaturesNeedAcquisitionStop)
+{
+  TestCamera camera(&node_cache_);
+  applyFirst(&camera);
+
+  SpinnakerConfig config = config_;
+  config.reverse_x = !config.reverse_x;
+  EXPECT_TRUE(camera.needsAcquisitionStop(config));
+
+  config = config_;
+  config.exposure_mode = "TriggerWidth";
+  EXPECT_TRUE(camera.needsAcquisitionStop(config));
+
+  config = config_;
+  config.image_format_x_binning = 2;
+  EXPECT_TRUE(camera.needsAcquisitionStop(config));
+
+  // Same group as ExposureMode, but not locked itself
+  config = config_;
+  config.exposure_auto = "Off";
+  EXPECT_FALSE(camera.needsAcquisitionStop(config));
+}
+
+TEST_F(CameraTest, lockedFeaturesTheModelLacksDoNotStop)
+{
+  TestCamera camera(&node_cache_, spinnaker_camera_driver::MODEL_CHAMELEON3);
+  applyFirst(&camera);
+
+  // The Chameleon3 has no ReverseX in the feature tables
+  SpinnakerConfig config = config_;
+  config.reverse_x = !config.reverse_x;
+  EXPECT_FALSE(camera.needsAcquisitionStop(config));
+}
+
+TEST_F(CameraTest, shrinkingROIResizesFirst)
+{
+  TestCamera camera(&node_cache_);
+  fakeNodeMap().writes.clear();
+
+  camera.setROI(100, 50, 400, 300);
+  const FakeNodeMap& node_map = fakeNodeMap();
+  ASSERT_NE(-1, node_map.writeIndex("Width=400"));
+  ASSERT_NE(-1, node_map.writeIndex("Height=300"));
+  EXPECT_LT(node_map.writeIndex("Width=400"), node_map.writeIndex("OffsetX=100"));
+  EXPECT_LT(node_map.writeIndex("Height=300"), node_map.writeIndex("OffsetY=50"));
+  EXPECT_EQ(100, camera.getROIXOffset());
+  EXPECT_EQ(400, camera.getROIWidth());
+}
+
+TEST_F(CameraTest, growingROIMovesFirst)
+{
+  TestCamera camera(&node_cache_);
+  camera.setROI(100, 50, 400, 300);
+  fakeNodeMap().writes.clear();
+
+  camera.setROI(0, 0, 1000, 800);
+  const FakeNodeMap& node_map = fakeNodeMap();
+  ASSERT_NE(-1, node_map.writeIndex("OffsetX=0"));
+  ASSERT_NE(-1, node_map.writeIndex("OffsetY=0"));
+  EXPECT_LT(node_map.writeIndex("OffsetX=0"), node_map.writeIndex("Width=1000"));
+  EXPECT_LT(node_map.writeIndex("OffsetY=0"), node_map.writeIndex("Height=800"));
+}
+
+TEST_F(CameraTest, movingROIOnlyWritesOffsets)
+{
+  TestCamera camera(&node_cache_);
+  camera.setROI(0, 0, 400, 300);
+  fakeNodeMap().writes.clear();
+
+  camera.setROI(200, 100, 400, 300);
+  EXPECT_EQ(std::vector<std::string>({ "OffsetX=200", "OffsetY=100" }), fakeNodeMap().writes);
+  EXPECT_FALSE(camera.roiNeedsAcquisitionStop(400, 300));
+}
+
+TEST_F(CameraTest, imageFormatChangedWhileRunningIsWrittenAtTheNextStop)
+{
+  TestCamera camera(&node_cache_);
+  applyFirst(&camera);
+
+  config_.image_format_x_binning = 2;
+  config_.brightness = 2.5;
+  camera.setNewConfiguration(config_, Camera::LEVEL_RECONFIGURE_RUNNING);
+  EXPECT_FALSE(fakeNodeMap().written("BinningHorizontal"));
+  EXPECT_TRUE(fakeNodeMap().written("BlackLevel"));
+
+  // Not taken for applied, so the binning still needs a stop and gets written then
+  EXPECT_TRUE(camera.needsAcquisitionStop(config_));
+  fakeNodeMap().writes.clear();
+  camera.setNewConfiguration(config_, Camera::LEVEL_RECONFIGURE_STOP);
+  EXPECT_NE(-1, fakeNodeMap().writeIndex("BinningHorizontal=2"));
+}
+
+TEST_F(CameraTest, skippedFeatureIsWrittenAgain)
+{
+  TestCamera camera(&node_cache_);
+  fakeNodeMap().read_only.insert("BlackLevel");
+  applyFirst(&camera);
+
+  fakeNodeMap().read_only.clear();
+  camera.setNewConfiguration(config_, Camera::LEVEL_RECONFIGURE_RUNNING);
+  EXPECT_TRUE(fakeNodeMap().written("BlackLevel"));
+
+  fakeNodeMap().writes.clear();
+  camera.setNewConfiguration(config_, Camera::LEVEL_RECONFIGURE_RUNNING);
+  EXPECT_TRUE(fakeNodeMap().writes.empty());
+}
+
+TEST_F(CameraTest, missingFeatureIsNotRetried)
+{
+  TestCamera camera(&node_cache_);
+  fakeNodeMap().missing.insert("BlackLevel");
+  applyFirst(&camera);
+
+  camera.setNewConfiguration(config_, Camera::LEVEL_RECONFIGURE_RUNNING);
+  EXPECT_TRUE(fakeNodeMap().writes.empty());
+}
+
+TEST_F(CameraTest, rejectedROIIsNotRecorded)
+{
+  TestCamera camera(&node_cache_);
+  applyFirst(&camera);
+
+  fakeNodeMap().read_only.insert("OffsetX");
+  EXPECT_THROW(camera.setROI(100, 50, 500, 400), std::runtime_error);
+  EXPECT_EQ(0, camera.getROIXOffset());
+  // The fake does not undo the size written before, the cached ROI follows what the camera holds
+  EXPECT_EQ(fakeNodeMap().numbers["Width"], camera.getROIWidth());
+  EXPECT_EQ(fakeNodeMap().numbers["Height"], camera.getROIHeight());
+}
+
+TEST_F(CameraTest, rejectedROISizeIsWrittenAgain)
+{
+  TestCamera camera(&node_cache_);
+  applyFirst(&camera);
+
+  fakeNodeMap().read_only.insert("Width");
+  config_.image_format_roi_width = 500;
+  camera.setNewConfiguration(config_, Camera::LEVEL_RECONFIGURE_STOP);
+  EXPECT_EQ(1000, camera.getROIWidth());
+  EXPECT_TRUE(camera.diffConfiguration(config_).image_format);
+
+  fakeNodeMap().read_only.clear();
+  fakeNodeMap().writes.clear();
+  camera.setNewConfiguration(config_, Camera::LEVEL_RECONFIGURE_STOP);
+  EXPECT_TRUE(fakeNodeMap().written("Width"));
+  EXPECT_EQ(500, camera.getROIWidth());
+  EXPECT_FALSE(camera.diffConfiguration(config_).image_format);
+}
+
+TEST_F(CameraTest, fullSizeROIMatchesZero)
+{
+  TestCamera camera(&node_cache_);
+  config_.image_format_roi_width = 0;
+  config_.image_format_roi_height = 0;
+  applyFirst(&camera);
+
+  camera.setROI(0, 0, 1000, 800);
+  EXPECT_FALSE(camera.diffConfiguration(config_).image_format);
+}
+
+TEST_F(CameraTest, onlyOnceAutoModesAreRestarted)
+{
+  TestCamera camera(&node_cache_);
+  config_.exposure_auto = "Once";
+  config_.auto_gain = "Off";
+  config_.auto_white_balance = "Continuous";
+  applyFirst(&camera);
+
+  camera.restartOnceAutoModes();
+  EXPECT_TRUE(fakeNodeMap().written("ExposureAuto"));
+  EXPECT_FALSE(fakeNodeMap().written("GainAuto"));
+  EXPECT_FALSE(fakeNodeMap().written("BalanceWhiteAuto"));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
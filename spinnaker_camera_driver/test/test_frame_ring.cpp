@@ -0,0 +1,147 @@
+/**
+Software License Agreement (BSD)
+
+\file      test_frame_ring.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "spinnaker_camera_driver/frame_ring.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using spinnaker_camera_driver::FrameRing;
+
+TEST(FrameRing, popsInOrder)
+{
+  FrameRing<int> ring(4, FrameRing<int>::DROP_OLDEST);
+  for (int i = 0; i < 3; ++i)
+    EXPECT_TRUE(ring.push(i));
+  EXPECT_EQ(3u, ring.size());
+
+  int value = -1;
+  for (int i = 0; i < 3; ++i)
+  {
+    ASSERT_TRUE(ring.pop(&value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_FALSE(ring.pop(&value));
+  EXPECT_EQ(0u, ring.size());
+}
+
+TEST(FrameRing, dropOldestOnOverflow)
+{
+  FrameRing<int> ring(3, FrameRing<int>::DROP_OLDEST);
+  for (int i = 0; i < 3; ++i)
+    EXPECT_TRUE(ring.push(i));
+  EXPECT_FALSE(ring.push(3));
+  EXPECT_FALSE(ring.push(4));
+
+  EXPECT_EQ(2u, ring.dropped());
+  EXPECT_EQ(5u, ring.pushed());
+  EXPECT_EQ(3u, ring.peakOccupancy());
+
+  // The newest frames survive
+  int value = -1;
+  for (int i = 2; i < 5; ++i)
+  {
+    ASSERT_TRUE(ring.pop(&value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_FALSE(ring.pop(&value));
+}
+
+TEST(FrameRing, dropNewestOnOverflow)
+{
+  FrameRing<int> ring(3, FrameRing<int>::DROP_NEWEST);
+  for (int i = 0; i < 3; ++i)
+    EXPECT_TRUE(ring.push(i));
+  EXPECT_FALSE(ring.push(3));
+
+  EXPECT_EQ(1u, ring.dropped());
+  EXPECT_EQ(3u, ring.pushed());
+
+  // The oldest frames survive
+  int value = -1;
+  for (int i = 0; i < 3; ++i)
+  {
+    ASSERT_TRUE(ring.pop(&value));
+    EXPECT_EQ(i, value);
+  }
+}
+
+TEST(FrameRing, waitPopTimesOut)
+{
+  FrameRing<int> ring(2, FrameRing<int>::DROP_OLDEST);
+  int value = -1;
+  EXPECT_FALSE(ring.waitPop(&value, std::chrono::milliseconds(10)));
+
+  ring.push(7);
+  EXPECT_TRUE(ring.waitPop(&value, std::chrono::milliseconds(10)));
+  EXPECT_EQ(7, value);
+}
+
+TEST(FrameRing, parsePolicy)
+{
+  FrameRing<int>::DropPolicy policy = FrameRing<int>::DROP_NEWEST;
+  EXPECT_TRUE(FrameRing<int>::parsePolicy("drop_oldest", &policy));
+  EXPECT_EQ(FrameRing<int>::DROP_OLDEST, policy);
+  EXPECT_TRUE(FrameRing<int>::parsePolicy("drop_newest", &policy));
+  EXPECT_EQ(FrameRing<int>::DROP_NEWEST, policy);
+  EXPECT_FALSE(FrameRing<int>::parsePolicy("drop_all", &policy));
+}
+
+// The producer drops the oldest frames while the consumer pops them, every frame must come out exactly once, in
+// order, or be counted as dropped.
+TEST(FrameRing, concurrentPopWithDropOldest)
+{
+  const uint64_t frames = 200000;
+  FrameRing<uint64_t> ring(4, FrameRing<uint64_t>::DROP_OLDEST);
+
+  std::vector<uint64_t> received;
+  received.reserve(frames);
+  std::thread consumer([&ring, &received, frames]() {
+    uint64_t value = 0;
+    while (received.empty() || received.back() != frames - 1)
+    {
+      if (ring.waitPop(&value, std::chrono::milliseconds(100)))
+        received.push_back(value);
+    }
+  });
+
+  for (uint64_t i = 0; i < frames; ++i)
+    ring.push(i);
+  consumer.join();
+
+  for (size_t i = 1; i < received.size(); ++i)
+    ASSERT_LT(received[i - 1], received[i]);
+  EXPECT_EQ(frames, received.size() + ring.dropped());
+  EXPECT_EQ(frames, ring.pushed());
+  EXPECT_LE(ring.peakOccupancy(), ring.capacity());
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,122 @@
+/**
+Software License Agreement (BSD)
+
+\file      test_frame_synchronizer.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "spinnaker_camera_driver/frame_synchronizer.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using spinnaker_camera_driver::FrameSynchronizer;
+
+typedef std::vector<std::vector<int> > Sets;
+
+TEST(FrameSynchronizer, groupsFramesWithinTolerance)
+{
+  FrameSynchronizer<int> synchronizer(2, 5, 4);
+  Sets sets;
+
+  synchronizer.add(0, 100, 10, &sets);
+  EXPECT_TRUE(sets.empty());
+  synchronizer.add(1, 103, 20, &sets);
+  ASSERT_EQ(1u, sets.size());
+  EXPECT_EQ(std::vector<int>({ 10, 20 }), sets[0]);
+
+  // The set is in input order whichever camera completes it
+  sets.clear();
+  synchronizer.add(1, 200, 21, &sets);
+  synchronizer.add(0, 196, 11, &sets);
+  ASSERT_EQ(1u, sets.size());
+  EXPECT_EQ(std::vector<int>({ 11, 21 }), sets[0]);
+
+  EXPECT_EQ(2u, synchronizer.statistics().matched);
+  EXPECT_EQ(0u, synchronizer.statistics().unmatched[0]);
+  EXPECT_EQ(0u, synchronizer.statistics().unmatched[1]);
+}
+
+TEST(FrameSynchronizer, discardsFramesThatTimedOut)
+{
+  FrameSynchronizer<int> synchronizer(2, 5, 4);
+  Sets sets;
+
+  // Input 1 missed the frame at 100, so input 0's frame can never be matched
+  synchronizer.add(0, 100, 10, &sets);
+  synchronizer.add(0, 200, 11, &sets);
+  synchronizer.add(1, 201, 21, &sets);
+  ASSERT_EQ(1u, sets.size());
+  EXPECT_EQ(std::vector<int>({ 11, 21 }), sets[0]);
+  EXPECT_EQ(1u, synchronizer.statistics().unmatched[0]);
+  EXPECT_EQ(0u, synchronizer.statistics().unmatched[1]);
+}
+
+TEST(FrameSynchronizer, dropsFramesOverCapacity)
+{
+  FrameSynchronizer<int> synchronizer(2, 5, 2);
+  Sets sets;
+
+  for (int i = 0; i < 5; ++i)
+    synchronizer.add(0, 100 * i, i, &sets);
+  EXPECT_TRUE(sets.empty());
+  EXPECT_EQ(3u, synchronizer.statistics().dropped[0]);
+
+  // Only the two newest frames are still waiting
+  synchronizer.add(1, 300, 30, &sets);
+  ASSERT_EQ(1u, sets.size());
+  EXPECT_EQ(std::vector<int>({ 3, 30 }), sets[0]);
+}
+
+TEST(FrameSynchronizer, clearsInputWhenKeyGoesBack)
+{
+  FrameSynchronizer<int> synchronizer(2, 5, 4);
+  Sets sets;
+
+  synchronizer.add(0, 100, 10, &sets);
+  synchronizer.add(0, 200, 11, &sets);
+  synchronizer.add(0, 50, 12, &sets);
+  EXPECT_EQ(2u, synchronizer.statistics().unmatched[0]);
+
+  synchronizer.add(1, 52, 20, &sets);
+  ASSERT_EQ(1u, sets.size());
+  EXPECT_EQ(std::vector<int>({ 12, 20 }), sets[0]);
+}
+
+TEST(FrameSynchronizer, waitsForEveryInput)
+{
+  FrameSynchronizer<int> synchronizer(3, 0, 4);
+  Sets sets;
+
+  synchronizer.add(0, 7, 1, &sets);
+  synchronizer.add(2, 7, 3, &sets);
+  EXPECT_TRUE(sets.empty());
+  synchronizer.add(1, 7, 2, &sets);
+  ASSERT_EQ(1u, sets.size());
+  EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), sets[0]);
+  EXPECT_EQ(3u, synchronizer.inputs());
+  EXPECT_EQ(0, synchronizer.tolerance());
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,105 @@
+/**
+Software License Agreement (BSD)
+
+\file      test_message_pool.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "spinnaker_camera_driver/message_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+using spinnaker_camera_driver::MessagePool;
+
+namespace
+{
+struct Message
+{
+  std::vector<uint8_t> data;
+};
+}  // namespace
+
+TEST(MessagePool, recyclesReleasedMessages)
+{
+  MessagePool<Message> pool(2);
+  EXPECT_EQ(0u, pool.available());
+
+  MessagePool<Message>::Ptr first = pool.acquire();
+  EXPECT_EQ(0u, pool.hits());
+  EXPECT_EQ(1u, pool.misses());
+
+  first->data.resize(1024);
+  const Message* address = first.get();
+  const uint8_t* buffer = first->data.data();
+  first.reset();
+  EXPECT_EQ(1u, pool.available());
+
+  // The same message comes back with its buffer still allocated
+  MessagePool<Message>::Ptr second = pool.acquire();
+  EXPECT_EQ(address, second.get());
+  EXPECT_EQ(buffer, second->data.data());
+  EXPECT_EQ(1u, pool.hits());
+  EXPECT_EQ(1u, pool.misses());
+  EXPECT_EQ(0u, pool.available());
+}
+
+TEST(MessagePool, waitsForEveryOwner)
+{
+  MessagePool<Message> pool(2);
+  MessagePool<Message>::Ptr message = pool.acquire();
+  MessagePool<Message>::Ptr subscriber = message;
+
+  message.reset();
+  EXPECT_EQ(0u, pool.available());
+  subscriber.reset();
+  EXPECT_EQ(1u, pool.available());
+}
+
+TEST(MessagePool, keepsAtMostCapacity)
+{
+  MessagePool<Message> pool(2);
+  std::vector<MessagePool<Message>::Ptr> messages;
+  for (int i = 0; i < 4; ++i)
+    messages.push_back(pool.acquire());
+  EXPECT_EQ(4u, pool.misses());
+
+  messages.clear();
+  EXPECT_EQ(2u, pool.available());
+  EXPECT_EQ(2u, pool.capacity());
+}
+
+TEST(MessagePool, messagesOutliveThePool)
+{
+  MessagePool<Message>::Ptr message;
+  {
+    MessagePool<Message> pool(1);
+    message = pool.acquire();
+  }
+  message->data.resize(16);
+  message.reset();
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
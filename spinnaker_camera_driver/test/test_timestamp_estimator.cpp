@@ -0,0 +1,129 @@
+/**
+Software License Agreement (BSD)
+
+\file      test_timestamp_estimator.cpp
+\copyright Copyright (c) 2018, Clearpath Robotics, Inc., All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+   following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+   following disclaimer in the documentation and/or other materials provided with the distribution.
+ * Neither the name of Clearpath Robotics nor the names of its contributors may be used to endorse or promote
+   products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WAR-
+RANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, IN-
+DIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "spinnaker_camera_driver/timestamp_estimator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+using spinnaker_camera_driver::TimestampEstimator;
+
+namespace
+{
+const double kHostStart = 1000.0;
+const double kFramePeriod = 0.01;
+const double kDrift = 100e-6;  // The host clock runs 100 ppm faster than the camera's
+
+// Host time at which the camera clock reads camera_seconds.
+double hostSeconds(const double camera_seconds)
+{
+  return kHostStart + camera_seconds * (1.0 + kDrift);
+}
+
+uint64_t cameraStamp(const int frame)
+{
+  return static_cast<uint64_t>(frame) * 10000000ull;
+}
+
+// Receive delay of a frame, between 1 and 2.8 ms with the least delayed frame of every block of ten at 1 ms.
+double delay(const int frame)
+{
+  return 0.001 + 0.0002 * ((frame * 7) % 10);
+}
+}  // namespace
+
+TEST(TimestampEstimator, returnsHostStampUntilEnoughSamples)
+{
+  TimestampEstimator estimator(10);
+  for (int i = 0; i < 9; ++i)
+  {
+    const ros::Time host(hostSeconds(i * kFramePeriod) + delay(i));
+    EXPECT_EQ(host.toSec(), estimator.update(cameraStamp(i), host).toSec());
+  }
+}
+
+TEST(TimestampEstimator, fitsDriftAndRemovesJitter)
+{
+  TimestampEstimator estimator(10, 0.001);
+  ros::Time stamp;
+  for (int i = 0; i < 200; ++i)
+    stamp = estimator.update(cameraStamp(i), ros::Time(hostSeconds(i * kFramePeriod) + delay(i)));
+
+  const TimestampEstimator::Statistics statistics = estimator.statistics();
+  EXPECT_NEAR(100.0, statistics.drift_ppm, 0.1);
+  EXPECT_EQ(10u, statistics.samples);
+  EXPECT_NEAR(0.0018, statistics.residual_max, 1e-6);
+  EXPECT_EQ(0u, statistics.resets);
+  EXPECT_FALSE(statistics.anchored);
+
+  // The least delayed frame minus the configured latency lands on the true capture time
+  EXPECT_NEAR(hostSeconds(199 * kFramePeriod), stamp.toSec(), 1e-6);
+}
+
+TEST(TimestampEstimator, resetsWhenClockGoesBack)
+{
+  TimestampEstimator estimator(10);
+  for (int i = 0; i < 50; ++i)
+    estimator.update(cameraStamp(i), ros::Time(hostSeconds(i * kFramePeriod) + delay(i)));
+  EXPECT_EQ(10u, estimator.statistics().samples);
+
+  // The camera restarted, its clock starts over
+  const ros::Time host(hostSeconds(50 * kFramePeriod));
+  EXPECT_EQ(host.toSec(), estimator.update(cameraStamp(1), host).toSec());
+
+  const TimestampEstimator::Statistics statistics = estimator.statistics();
+  EXPECT_EQ(1u, statistics.resets);
+  EXPECT_EQ(1u, statistics.samples);
+  EXPECT_EQ(0.0, statistics.drift_ppm);
+}
+
+TEST(TimestampEstimator, anchorFixesOffset)
+{
+  TimestampEstimator estimator(10);
+
+  // Latch the camera clock at 0 within a 0.4 ms round trip, before any frame
+  estimator.anchor(cameraStamp(0), ros::Time(hostSeconds(0.0) - 0.0002), ros::Time(hostSeconds(0.0) + 0.0002));
+  EXPECT_TRUE(estimator.statistics().anchored);
+  EXPECT_NEAR(0.0002, estimator.statistics().anchor_uncertainty, 1e-9);
+
+  // The anchor maps the very first frame, without waiting for enough samples
+  ros::Time stamp = estimator.update(cameraStamp(1), ros::Time(hostSeconds(kFramePeriod) + delay(1)));
+  EXPECT_NEAR(hostSeconds(kFramePeriod), stamp.toSec(), 2e-6);
+
+  for (int i = 2; i < 200; ++i)
+    stamp = estimator.update(cameraStamp(i), ros::Time(hostSeconds(i * kFramePeriod) + delay(i)));
+  EXPECT_NEAR(hostSeconds(199 * kFramePeriod), stamp.toSec(), 1e-6);
+
+  // The frames only tell the transport latency now
+  EXPECT_NEAR(0.001, estimator.statistics().latency, 1e-6);
+
+  estimator.reset();
+  EXPECT_FALSE(estimator.statistics().anchored);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}